@@ -0,0 +1,133 @@
+/*
+ * ActiveExecutor.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "ActiveExecutor.h"
+#include "ActiveModule.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+ActiveExecutor::ActiveExecutor(const char* name, uint8_t num_workers, uint16_t max_modules, osPriority priority, uint32_t stack_size, uint32_t tick_millis){
+	_max_modules = max_modules;
+	_modules = new ActiveModule*[max_modules]();
+	MBED_ASSERT(_modules);
+	_num_modules = 0;
+	_tick_millis = tick_millis;
+	_next_tick = (uint32_t)Kernel::get_ms_count() + tick_millis;
+	for(uint8_t i = 0; i < MaxBands; i++){
+		_ready[i].items = new ActiveModule*[max_modules]();
+		MBED_ASSERT(_ready[i].items);
+		_ready[i].head = 0;
+		_ready[i].count = 0;
+	}
+	_sem = new Semaphore(0, max_modules);
+	MBED_ASSERT(_sem);
+	_num_workers = (num_workers > MaxWorkers)? MaxWorkers : num_workers;
+	for(uint8_t i = 0; i < _num_workers; i++){
+		_workers[i] = new Thread(priority, stack_size, NULL, name);
+		MBED_ASSERT(_workers[i]);
+		_workers[i]->start(callback(this, &ActiveExecutor::worker));
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveExecutor::attach(ActiveModule* module){
+	bool result = false;
+	core_util_critical_section_enter();
+	uint16_t count = _num_modules;
+	if(count < _max_modules){
+		_modules[count] = module;
+		_num_modules = count + 1;
+		result = true;
+	}
+	core_util_critical_section_exit();
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveExecutor::schedule(ActiveModule* module){
+	osPriority prio = module->getPriority();
+	Band band = (prio > osPriorityNormal)? BandHigh : ((prio < osPriorityNormal)? BandLow : BandNormal);
+	ReadyList& rl = _ready[band];
+	core_util_critical_section_enter();
+	// un modulo solo puede estar una vez en las listas y attach limita los modulos a max_modules
+	MBED_ASSERT(rl.count < _max_modules);
+	rl.items[(rl.head + rl.count) % _max_modules] = module;
+	rl.count++;
+	core_util_critical_section_exit();
+	_sem->release();
+}
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE METHODS IMPLEMENTATION --------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+ActiveModule* ActiveExecutor::pop(){
+	ActiveModule* module = NULL;
+	core_util_critical_section_enter();
+	for(uint8_t i = 0; i < MaxBands; i++){
+		ReadyList& rl = _ready[i];
+		if(rl.count){
+			module = rl.items[rl.head];
+			rl.head = (rl.head + 1) % _max_modules;
+			rl.count--;
+			break;
+		}
+	}
+	core_util_critical_section_exit();
+	return module;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveExecutor::worker(){
+	for(;;){
+		if(_sem->wait(millisToTick()) > 0){
+			ActiveModule* module = pop();
+			if(module){
+				module->executorRun();
+			}
+		}
+		tick();
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveExecutor::tick(){
+	uint32_t now = (uint32_t)Kernel::get_ms_count();
+	uint32_t next = _next_tick;
+	// solo el thread que adelanta _next_tick atiende el tick
+	if(!_tick_millis || (int32_t)(now - next) < 0 || !_next_tick.compare_exchange_strong(next, now + _tick_millis)){
+		return;
+	}
+	uint16_t count = _num_modules;
+	for(uint16_t i = 0; i < count; i++){
+		if(_modules[i]->hasPeriodicTasks()){
+			_modules[i]->scheduleRun();
+		}
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t ActiveExecutor::millisToTick(){
+	if(!_tick_millis){
+		return osWaitForever;
+	}
+	int32_t wait = (int32_t)(_next_tick - (uint32_t)Kernel::get_ms_count());
+	return (wait > 0)? (uint32_t)wait : 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * ActiveExecutor.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	ActiveExecutor ejecuta varios ActiveModule sobre un conjunto reducido de threads de trabajo, en lugar de un
+ *	thread (y su stack) por modulo. Cada modulo se comporta como un actor de ejecucion hasta completar: cuando
+ *	recibe un mensaje estando inactivo se encola en la lista de modulos listos, y un thread de trabajo procesa
+ *	sus mensajes pendientes (hasta su tamano de lote) antes de liberarlo. Un modulo nunca esta en la lista mas de
+ *	una vez, por lo que sus manejadores siempre se ejecutan de forma serializada.
+ *
+ *	Los modulos listos se atienden por bandas de prioridad segun la prioridad indicada al construirlos. Todos los
+ *	threads de trabajo comparten las mismas listas, de forma que cualquier thread libre atiende al siguiente
+ *	modulo listo.
+ *
+ *	Cada periodo de tick, uno de los threads de trabajo encola los modulos con tareas periodicas (metricas, volcado
+ *	de ParamCache), de forma que estas se ejecutan aunque el modulo no reciba mensajes.
+ */
+
+#ifndef __ActiveExecutor__H
+#define __ActiveExecutor__H
+
+#include "mbed.h"
+#include <atomic>
+
+class ActiveModule;
+
+
+class ActiveExecutor {
+  public:
+
+	/** Maximo numero de threads de trabajo */
+	static const uint8_t MaxWorkers = 8;
+
+	/** Periodo por defecto del tick de tareas periodicas (ms) */
+	static const uint32_t DefaultTickMillis = 100;
+
+
+    /** Constructor
+     *  @param name Nombre base de los threads de trabajo
+     *  @param num_workers Numero de threads de trabajo (max MaxWorkers)
+     *  @param max_modules Maximo numero de modulos asociados al executor
+     *  @param priority Prioridad de los threads de trabajo
+     *  @param stack_size Tamano de stack de cada thread de trabajo
+     *  @param tick_millis Periodo del tick de tareas periodicas (0: deshabilitado)
+     */
+	ActiveExecutor(const char* name, uint8_t num_workers, uint16_t max_modules, osPriority priority = osPriorityNormal, uint32_t stack_size = OS_STACK_SIZE, uint32_t tick_millis = DefaultTickMillis);
+
+
+    /** Asocia un modulo al executor (desde su constructor)
+     *  @param module Modulo
+     *  @return False si el executor ya tiene max_modules modulos asociados
+     */
+	bool attach(ActiveModule* module);
+
+
+    /** Encola un modulo en la lista de modulos listos. ISR-safe.
+     *  @param module Modulo asociado con attach
+     */
+	void schedule(ActiveModule* module);
+
+  private:
+
+	/** Bandas de prioridad de los modulos */
+	enum Band{
+		BandHigh = 0,
+		BandNormal,
+		BandLow,
+		MaxBands
+	};
+
+	/** Lista circular de modulos listos de una banda */
+	struct ReadyList {
+		ActiveModule** items;
+		uint16_t head;
+		uint16_t count;
+	};
+
+	ReadyList _ready[MaxBands];					/// Modulos listos por banda
+	uint16_t _max_modules;						/// Capacidad de cada lista
+	ActiveModule** _modules;					/// Modulos asociados
+	std::atomic<uint16_t> _num_modules;			/// Numero de modulos asociados
+	Semaphore* _sem;							/// Numero de modulos listos
+	Thread* _workers[MaxWorkers];				/// Threads de trabajo
+	uint8_t _num_workers;
+	uint32_t _tick_millis;						/// Periodo del tick (0: deshabilitado)
+	std::atomic<uint32_t> _next_tick;			/// Instante del siguiente tick
+
+    /** Extrae el siguiente modulo listo, de la banda mas prioritaria
+     *  @return Modulo o NULL si no hay ninguno
+     */
+	ActiveModule* pop();
+
+
+    /** Hilo de ejecucion de cada thread de trabajo
+     */
+	void worker();
+
+
+    /** Si ha vencido el tick y ningun otro thread lo ha atendido, encola los modulos con tareas periodicas
+     */
+	void tick();
+
+
+    /** Obtiene el tiempo hasta el siguiente tick
+     *  @return Milisegundos (osWaitForever si esta deshabilitado)
+     */
+	uint32_t millisToTick();
+};
+
+#endif /*__ActiveExecutor__H */
+
+/**** END OF FILE ****/
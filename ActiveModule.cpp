@@ -6,6 +6,7 @@
  */
 
 #include "ActiveModule.h"
+#include <new>
 
 
 //------------------------------------------------------------------------------------
@@ -13,7 +14,9 @@
 //------------------------------------------------------------------------------------
 #define _MODULE_ 	_name
 #define _EXPR_		(_defdbg && !IS_ISR())
-int32_t ActiveModule::_max_queue_count = 0;
+#define _EXPR_ISR_	(_defdbg)			/// Trazas diferidas del camino critico (DeferredLog, ISR-safe)
+std::atomic<int32_t> ActiveModule::_max_queue_count(0);
+MsgPool* ActiveModule::_msg_blocks = NULL;
 
 
 //------------------------------------------------------------------------------------
@@ -23,68 +26,363 @@ int32_t ActiveModule::_max_queue_count = 0;
 
 //------------------------------------------------------------------------------------
 ActiveModule::ActiveModule(const char* name, osPriority priority, uint32_t stack_size, FSManager* fs, bool defdbg) : StateMachine(){
-	_queue_count = 0;
-	// Inicializa flag de estado, propiedades internas y thread
-	_ready = false;
-	_defdbg = defdbg;
-	strcpy((char*)_name, "[");
-	strncat((char*)_name, name, MaxNameLength-2);
-	strcat((char*)_name, "]");
-	memset(&_name[strlen(_name)], '.', MaxNameLength - strlen(_name) + 1);
-	_name[MaxNameLength] = 0;
-	_fs = fs;
+	init(name, priority, fs, defdbg);
+	_executor = NULL;
 	_th = new Thread(priority, stack_size, NULL, name);
-	_pub_topic_base = NULL;
-	_sub_topic_base = NULL;
-	_wdt_handled = false;
-	_wdt_millis = osWaitForever;
 
-    // Asigno manejador de mensajes en el Mailbox
-    StateMachine::attachMessageHandler(new Callback<osStatus(State::Msg*)>(this, &ActiveModule::putMessage));
+    // Inicia thread
+	_th->start(callback(this, &ActiveModule::task));
+}
 
-    // creo m�quinas de estado inicial
-    _stInit.setHandler(callback(this, &ActiveModule::Init_EventHandler));
 
-    // Inicia thread
+//------------------------------------------------------------------------------------
+ActiveModule::ActiveModule(const char* name, ActiveExecutor* executor, osPriority priority, FSManager* fs, bool defdbg) : StateMachine(){
+	init(name, priority, fs, defdbg);
+	_executor = NULL;
+	_th = NULL;
+	if(executor->attach(this)){
+		_executor = executor;
+		return;
+	}
+	// executor completo: se ejecuta con thread propio
+	DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERR_EXEC Executor completo, se ejecuta con thread propio");
+	_th = new Thread(priority, OS_STACK_SIZE, NULL, name);
 	_th->start(callback(this, &ActiveModule::task));
-	_sem_th.wait();
 }
 
 
 
 //------------------------------------------------------------------------------------
-void ActiveModule::attachToTaskWatchdog(uint32_t millis, const char* wdog_topic, const char* wdog_name) {
-	_wdt_topic = new char[strlen(wdog_topic)+1]();
-	MBED_ASSERT(_wdt_topic);
-	strcpy(_wdt_topic, wdog_topic);
-	_wdt_name = new char[strlen(wdog_name)+1]();
+bool ActiveModule::dependsOn(ActiveModule* dep){
+	bool result = false;
+	core_util_critical_section_enter();
+	uint8_t i, j;
+	for(i = 0; i < MaxDependencies && _deps[i]; i++);
+	for(j = 0; j < MaxDependencies && dep->_dependents[j]; j++);
+	if(i < MaxDependencies && j < MaxDependencies){
+		_deps[i] = dep;
+		dep->_dependents[j] = this;
+		result = true;
+	}
+	core_util_critical_section_exit();
+	if(!result){
+		DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERR_DEPS Sin espacio para la dependencia %s", dep->_name);
+	}
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::attachToTaskWatchdog(uint32_t millis, const char* wdog_topic, const char* wdog_name) {
+	if(_executor){
+		DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERR_WDT Modulo en ActiveExecutor, sin thread que vigilar");
+		return false;
+	}
+	if(wdog_topic){
+		_wdt_topic = new char[strlen(wdog_topic)+1]();
+		MBED_ASSERT(_wdt_topic);
+		strcpy(_wdt_topic, wdog_topic);
+	}
+	_wdt_name_len = strlen(wdog_name)+1;
+	_wdt_name = new char[_wdt_name_len]();
 	MBED_ASSERT(_wdt_name);
 	strcpy(_wdt_name, wdog_name);
 
-	if(MQ::MQClient::publish(_wdt_topic, _wdt_name, strlen(_wdt_name)+1, &_publicationCb) == MQ::SUCCESS){
-		_wdt_handled = true;
-		_wdt_millis = millis;
-		DEBUG_TRACE_D(_EXPR_, _MODULE_, "Registrado componente %s en TaskWatchdog", _wdt_name);
-	}
-	else{
+	if(_wdt_topic && MQ::MQClient::publish(_wdt_topic, _wdt_name, _wdt_name_len, &_publicationCb) != MQ::SUCCESS){
 		_wdt_handled = false;
 		_wdt_millis = osWaitForever;
 		DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERROR: Registrando componente %s en TaskWatchdog", _wdt_name);
+		return false;
+	}
+	if(_wdt_id < 0 && (_wdt_id = TaskHeartbeat::attach(_wdt_name, millis)) < 0){
+		DEBUG_TRACE_W(_EXPR_, _MODULE_, "ERR_WDT Tabla TaskHeartbeat llena, registrando %s", _wdt_name);
+	}
+	_wdt_last = TaskHeartbeat::now();
+	_wdt_millis = millis;
+	_wdt_handled = true;
+	DEBUG_TRACE_D(_EXPR_, _MODULE_, "Registrado componente %s en TaskWatchdog", _wdt_name);
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------
+osStatus ActiveModule::putMessage(State::Msg *msg, uint8_t lane){
+	if(lane >= MaxLanes){
+		lane = LaneNormal;
+	}
+	if(isManagedMessage(msg)){
+		getMsgBlock(msg)->lane = lane;
+	}
+	return putMessage(msg);
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::getLaneStats(uint8_t lane, LaneStats& stats){
+	stats.depth = _lanes[lane].depth;
+	stats.max_depth = _lanes[lane].max_depth;
+	stats.puts = _lanes[lane].puts;
+	stats.rejects = _lanes[lane].rejects;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::getMemoryReport(MemoryReport& report){
+	report.stack_size = (_th)? _th->stack_size() : 0;
+	report.stack_max = (_th)? _th->max_stack() : 0;
+	report.queue_size = _lanes[LaneNormal].limit;
+	report.queue_max = _metrics.queue_max_depth;
+	report.msg_bytes = _msg_bytes;
+	report.msg_bytes_max = _msg_bytes_max;
+}
+
+
+//------------------------------------------------------------------------------------
+int ActiveModule::exportMemoryReport(char* buf, size_t len){
+	MemoryReport r;
+	getMemoryReport(r);
+	// el nombre se guarda como "[Name]....", se exporta sin decoracion
+	const char* name = &_name[1];
+	int name_len = strcspn(name, "]");
+	return snprintf(buf, len, "{\"module\":\"%.*s\",\"stack_size\":%u,\"stack_max\":%u,\"queue_size\":%u,\"queue_max\":%u,\"msg_bytes_max\":%u}",
+			name_len, name, (unsigned)r.stack_size, (unsigned)r.stack_max, (unsigned)r.queue_size, (unsigned)r.queue_max, (unsigned)r.msg_bytes_max);
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::enableTrace(uint32_t records){
+	if(!_trace){
+		_trace = new TraceRecorder(_name, records);
+		MBED_ASSERT(_trace);
+	}
+	_trace->enable(true);
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t ActiveModule::dumpTrace(FILE* f){
+	if(!_trace){
+		return 0;
+	}
+	uint32_t count = _trace->dump(f);
+	DEBUG_TRACE_I(_EXPR_, _MODULE_, "Volcados %d registros de traza", (int)count);
+	return count;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::setSignalPolicy(uint32_t sig, OverloadPolicy policy, uint32_t millis){
+	for(uint8_t i = 0; i < MaxSignalPolicies; i++){
+		if(_sig_policies[i].sig == sig || _sig_policies[i].sig == 0){
+			if(_sig_policies[i].sig == 0){
+				_sig_policies[i].coalesce = false;
+			}
+			_sig_policies[i].policy = policy;
+			_sig_policies[i].millis = millis;
+			_sig_policies[i].sig = sig;
+			return true;
+		}
 	}
+	DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERR_POLICY Sin espacio para la senal 0x%x", (int)sig);
+	return false;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::setSignalCoalescing(uint32_t sig, bool enable){
+	for(uint8_t i = 0; i < MaxSignalPolicies; i++){
+		if(_sig_policies[i].sig == sig || _sig_policies[i].sig == 0){
+			// una senal sin politica propia mantiene la del modulo
+			if(_sig_policies[i].sig == 0){
+				_sig_policies[i].policy = _policy.policy;
+				_sig_policies[i].millis = _policy.millis;
+			}
+			_sig_policies[i].coalesce = enable;
+			_sig_policies[i].sig = sig;
+			return true;
+		}
+	}
+	DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERR_POLICY Sin espacio para la senal 0x%x", (int)sig);
+	return false;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::getOverloadStats(OverloadStats& stats){
+	stats.rejected = _overload.rejected;
+	stats.timeouts = _overload.timeouts;
+	stats.dropped = _overload.dropped;
+	stats.replaced = _overload.replaced;
+	stats.merged = _overload.merged;
 }
 
 
 //------------------------------------------------------------------------------------
 osStatus ActiveModule::putMessage(State::Msg *msg){
-	if(++_queue_count > _max_queue_count){
-		_max_queue_count = _queue_count;
-		DEBUG_TRACE_V(_EXPR_, _MODULE_, "QUEUE_COUNT = %d", _queue_count);
+	return postMessage(msg, true);
+}
+
+
+//------------------------------------------------------------------------------------
+osStatus ActiveModule::postMessage(State::Msg* msg, bool can_block){
+	uint8_t lane = getMsgLane(msg);
+	const SignalPolicy& sp = getSignalPolicy(msg->sig);
+	uint32_t millis = (sp.policy == PolicyBlock && can_block && !IS_ISR())? sp.millis : 0;
+
+	if(_trace){
+		_trace->record(TraceRecorder::RecPut, msg->sig, (isManagedMessage(msg))? msg->msg : NULL, getMsgSize(msg), 0, lane);
 	}
-    osStatus ost = _queue.put(msg, ActiveModule::DefaultPutTimeout);
-    if(ost != osOK){
-        DEBUG_TRACE_E(_EXPR_, _MODULE_, "QUEUE_PUT_ERROR %d", ost);
-    }
-    return ost;
+
+	// las senales fusionables sustituyen los datos del mensaje pendiente equivalente, manteniendo su posicion
+	if(sp.coalesce && pendingReplace(msg)){
+		_overload.merged++;
+		return osOK;
+	}
+	bool tracked = (sp.policy == PolicyReplace || sp.coalesce)? pendingAdd(msg) : false;
+
+	if(isManagedMessage(msg)){
+		getMsgBlock(msg)->ts = us_ticker_read();
+	}
+
+	// se contabiliza antes de encolarlo, ya que el consumidor lo descuenta al extraerlo
+	int32_t count = ++_queue_count;
+	osStatus ost = mailboxPut(msg, lane, millis, (sp.policy == PolicyDropOldest));
+	if(ost == osOK){
+		uint32_t max = _metrics.queue_max_depth;
+		while((uint32_t)count > max && !_metrics.queue_max_depth.compare_exchange_weak(max, count));
+		int32_t gmax = _max_queue_count;
+		while(count > gmax && !_max_queue_count.compare_exchange_weak(gmax, count));
+		if(count > gmax){
+			DEFERRED_TRACE_V(_EXPR_ISR_, _MODULE_, "QUEUE_COUNT = %d", (int)count);
+		}
+		if(_executor){
+			scheduleRun();
+		}
+		return osOK;
+	}
+	_queue_count--;
+	if(tracked){
+		pendingRemove(msg);
+	}
+
+	// aplica la politica de sobrecarga
+	switch(sp.policy){
+		case PolicyReplace:
+			if(pendingReplace(msg)){
+				_overload.replaced++;
+				return osOK;
+			}
+			break;
+		case PolicyBlock:
+			if(millis){
+				_overload.timeouts++;
+			}
+			break;
+		default:
+			break;
+	}
+	_overload.rejected++;
+	if(_trace){
+		_trace->record(TraceRecorder::RecReject, msg->sig, NULL, 0);
+	}
+	DEFERRED_TRACE_E(_EXPR_ISR_, _MODULE_, "QUEUE_PUT_ERROR %d", (int)ost);
+	disposeMessage(msg);
+	return ost;
+}
+
+
+//------------------------------------------------------------------------------------
+State::Msg* ActiveModule::newMessage(uint32_t sig, uint16_t size){
+	// el bloque se reserva siempre de un pool, para identificarlo por rango de direcciones (isManagedMessage)
+	MsgBlock* blk = (MsgBlock*)((_pool)? _pool->alloc(sizeof(MsgBlock), false) : NULL);
+	if(!blk){
+		blk = (MsgBlock*)_msg_blocks->alloc(sizeof(MsgBlock), false);
+	}
+	if(!blk){
+		DEFERRED_TRACE_E(_EXPR_ISR_, _MODULE_, "ERR_MSG Sin memoria para el mensaje 0x%x", (int)sig);
+		return NULL;
+	}
+	blk->size = size;
+	blk->flags = 0;
+	blk->lane = LaneNormal;
+	blk->key = 0;
+	blk->corr = 0;
+	blk->reply_to = NULL;
+	blk->msg.sig = sig;
+	blk->msg.msg = NULL;
+	if(size > InlinePayloadSize){
+		if((blk->msg.msg = memAlloc(size)) == NULL){
+			DEFERRED_TRACE_E(_EXPR_ISR_, _MODULE_, "ERR_MSG Sin memoria para los datos del mensaje 0x%x", (int)sig);
+			MsgPool::findBlock(blk, sizeof(MsgBlock))->free(blk);
+			return NULL;
+		}
+	}
+	else if(size > 0){
+		blk->flags |= MsgBlockInline;
+		blk->msg.msg = blk->data;
+	}
+	blk->tag = MsgBlockTag ^ (uint32_t)(uintptr_t)blk;
+	msgAccount(sizeof(MsgBlock) + ((size > InlinePayloadSize)? size : 0));
+	return &blk->msg;
+}
+
+
+//------------------------------------------------------------------------------------
+State::Msg* ActiveModule::newMessage(uint32_t sig, const void* data, uint16_t size){
+	State::Msg* msg = newMessage(sig, size);
+	if(msg && data && size){
+		memcpy(msg->msg, data, size);
+	}
+	return msg;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::disposeMessage(State::Msg* msg){
+	if(isManagedMessage(msg)){
+		releaseMessage(msg);
+		return;
+	}
+	memFree(msg->msg);
+	memFree(msg);
+}
+
+
+//------------------------------------------------------------------------------------
+State::Msg* ActiveModule::newMessageRef(uint32_t sig, void* data, uint16_t size){
+	if(!RefBuffer::retain(data)){
+		return newMessage(sig, data, size);
+	}
+	State::Msg* msg = newMessage(sig);
+	if(!msg){
+		RefBuffer::release(data);
+		return NULL;
+	}
+	MsgBlock* blk = getMsgBlock(msg);
+	blk->flags |= MsgBlockRefBuffer;
+	blk->size = size;
+	msg->msg = data;
+	return msg;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::releaseMessage(State::Msg* msg){
+	MsgPool* owner = blockOwner(msg);
+	if(!owner){
+		return;
+	}
+	MsgBlock* blk = getMsgBlock(msg);
+	if(blk->flags & MsgBlockRefBuffer){
+		RefBuffer::release(blk->msg.msg);
+	}
+	else if(!(blk->flags & MsgBlockInline)){
+		memFree(blk->msg.msg);
+		msgAccount(-(int32_t)blk->size);
+	}
+	msgAccount(-(int32_t)sizeof(MsgBlock));
+	blk->tag = 0;
+	owner->free(blk);
 }
 
 
@@ -94,51 +392,735 @@ osStatus ActiveModule::putMessage(State::Msg *msg){
 
 
 //------------------------------------------------------------------------------------
-void ActiveModule::task() {
-	_sem_th.release();
+void ActiveModule::init(const char* name, osPriority priority, FSManager* fs, bool defdbg){
+	// pool compartido de mensajes gestionados, creado con el primer modulo
+	if(!_msg_blocks){
+		static const MsgPool::SizeClass msg_blocks[] = { {MsgBlockSize, ACTIVEMODULE_MSG_BLOCKS} };
+		MsgPool* pool = new MsgPool(msg_blocks, 1);
+		MBED_ASSERT(pool);
+		core_util_critical_section_enter();
+		if(!_msg_blocks){
+			_msg_blocks = pool;
+			pool = NULL;
+		}
+		core_util_critical_section_exit();
+		delete pool;
+	}
+	// pool por defecto de RefBuffer, si la aplicacion no ha asignado uno
+	if(ACTIVEMODULE_REF_BUFFERS > 0 && !RefBuffer::getPool()){
+		const MsgPool::SizeClass ref_buffers[] = { {(uint16_t)RefBuffer::blockSize(ACTIVEMODULE_REF_BUFFER_SIZE), ACTIVEMODULE_REF_BUFFERS} };
+		MsgPool* pool = new MsgPool(ref_buffers, 1);
+		MBED_ASSERT(pool);
+		core_util_critical_section_enter();
+		if(!RefBuffer::getPool()){
+			RefBuffer::setPool(pool);
+			pool = NULL;
+		}
+		core_util_critical_section_exit();
+		delete pool;
+	}
+	_queue_count = 0;
+	// Inicializa flag de estado y propiedades internas
+	_ready = false;
+	_defdbg = defdbg;
+	strcpy((char*)_name, "[");
+	strncat((char*)_name, name, MaxNameLength-2);
+	strcat((char*)_name, "]");
+	memset(&_name[strlen(_name)], '.', MaxNameLength - strlen(_name) + 1);
+	_name[MaxNameLength] = 0;
+	_fs = fs;
+	_pool = NULL;
+	_topic_map = NULL;
+	_param_cache = NULL;
+	_cfg_shadow = NULL;
+	_timers = NULL;
+	_trace = NULL;
+	_priority = priority;
+	_scheduled = false;
+	_started = false;
+	_start_forced = false;
+	_startup_ms = (uint32_t)Kernel::get_ms_count();
+	for(uint8_t i = 0; i < MaxDependencies; i++){
+		_deps[i] = NULL;
+		_dependents[i] = NULL;
+	}
+	_pub_topic_base = NULL;
+	_sub_topic_base = NULL;
+	_wdt_handled = false;
+	_wdt_millis = osWaitForever;
+	_wdt_topic = NULL;
+	_wdt_name = NULL;
+	_wdt_id = -1;
+	_mbx_type = RtosMailbox;
+	_lf_lanes = NULL;
+	_mbx_credit = 0;
+	for(uint8_t i = 0; i < MaxLanes; i++){
+		_lanes[i].depth = 0;
+		_lanes[i].max_depth = 0;
+		_lanes[i].puts = 0;
+		_lanes[i].rejects = 0;
+		_lanes[i].waiters = 0;
+		_lanes[i].limit = laneCapacity(i);
+	}
+	_starvation_limit = 0;
+	_starvation_count = 0;
+	_batch_size = 1;
+	_policy.sig = 0;
+	_policy.policy = PolicyBlock;
+	_policy.millis = DefaultPutTimeout;
+	_policy.coalesce = false;
+	for(uint8_t i = 0; i < MaxSignalPolicies; i++){
+		_sig_policies[i].sig = 0;
+	}
+	_pending_count = 0;
+	resetMetrics();
+	_metrics_period = 0;
+	_metrics_last = 0;
+	_metrics_topic.name = NULL;
+	_overload.rejected = 0;
+	_overload.timeouts = 0;
+	_overload.dropped = 0;
+	_overload.replaced = 0;
+	_overload.merged = 0;
+	_msg_bytes = 0;
+	_msg_bytes_max = 0;
+	for(uint8_t i = 0; i < ACTIVEMODULE_MAX_CALLS; i++){
+		_calls[i].corr = 0;
+		_calls[i].closing = false;
+		_calls[i].expired = false;
+	}
+	_call_seq = 0;
+
+    // Asigno manejador de mensajes en el Mailbox
+    _msg_handler = callback(this, static_cast<osStatus (ActiveModule::*)(State::Msg*)>(&ActiveModule::putMessage));
+    StateMachine::attachMessageHandler(&_msg_handler);
+
+    // creo m�quinas de estado inicial
+    _stInit.setHandler(callback(this, &ActiveModule::Init_EventHandler));
+}
+
 
-    // espera a que se asigne un topic base
-    while(!_pub_topic_base || !_sub_topic_base){
-    	Thread::wait(100);
+//------------------------------------------------------------------------------------
+void ActiveModule::task() {
+    // espera a que se asignen los topics base y se inicien sus dependencias, notificado por startupNotify
+    while(!startupReady()){
+    	_sem_th.wait();
     }
 
     // asigna m�quina de estados por defecto  y la inicia
     initState(&_stInit);
+    startupCompleted();
 
     // Ejecuta m�quinas de estados y espera mensajes que son delegados a la m�quina de estados
     // de la clase heredera
     for(;;){
         osEvent oe = getOsEvent();
-        run(&oe);
+        batchStarted();
+        dispatch(&oe);
+        // procesa el resto del lote con los mensajes ya pendientes, sin esperar ni notificar al TaskWatchdog
+        uint32_t count = 1;
+        while(count < _batch_size){
+        	oe = mailboxGet(0);
+        	if(oe.status != osEventMessage){
+        		break;
+        	}
+        	dispatch(&oe);
+        	count++;
+        }
+        batchCompleted(count);
     }
 }
 
 
+//------------------------------------------------------------------------------------
+bool ActiveModule::startupReady(){
+	if(!_start_forced && (!_pub_topic_base || !_sub_topic_base)){
+		return false;
+	}
+	for(uint8_t i = 0; i < MaxDependencies && _deps[i]; i++){
+		if(!_deps[i]->_started){
+			return false;
+		}
+	}
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::startupCompleted(){
+	_startup_ms = (uint32_t)Kernel::get_ms_count() - _startup_ms;
+	_started = true;
+	DEBUG_TRACE_I(_EXPR_, _MODULE_, "Arranque completado en %d ms", (int)_startup_ms);
+	// los dependientes registrados tras este punto ya ven _started y no necesitan notificacion
+	ActiveModule* dependents[MaxDependencies];
+	core_util_critical_section_enter();
+	memcpy(dependents, _dependents, sizeof(dependents));
+	core_util_critical_section_exit();
+	for(uint8_t i = 0; i < MaxDependencies && dependents[i]; i++){
+		dependents[i]->startupNotify();
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::executorRun(){
+	if(!_started){
+		// espera a que se asignen los topics base y se inicien sus dependencias, que volveran a encolar el modulo
+		if(!startupReady()){
+			_scheduled = false;
+			if(startupReady()){
+				scheduleRun();
+			}
+			return;
+		}
+		initState(&_stInit);
+		startupCompleted();
+	}
+
+	// procesa un lote de mensajes pendientes sin bloquear el thread de trabajo
+	uint32_t count = 0;
+	while(count < _batch_size){
+		osEvent oe = mailboxGet(0);
+		if(oe.status != osEventMessage){
+			break;
+		}
+		if(count == 0){
+			batchStarted();
+		}
+		dispatch(&oe);
+		count++;
+	}
+	if(count){
+		batchCompleted(count);
+	}
+	periodicTasks();
+
+	// libera el modulo; si ha completado el lote o entretanto se ha publicado algun mensaje cuyo productor no ha
+	// podido encolarlo, se encola de nuevo. Un mensaje reservado sin publicar no lo encola: su productor lo hara.
+	bool pending = (count == _batch_size);
+	_scheduled = false;
+	if(!pending && _mbx_sem.wait(0) > 0){
+		_mbx_credit++;
+		pending = true;
+	}
+	if(pending){
+		scheduleRun();
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::dispatch(osEvent* oe){
+	State::Msg* msg = (oe->status == osEventMessage)? (State::Msg*)oe->value.p : NULL;
+	// se decide antes de run(), ya que los manejadores liberan los mensajes no gestionados
+	bool managed = isManagedMessage(msg);
+	uint32_t t0 = us_ticker_read();
+	if(managed){
+		// latencia encolado-despacho en el histograma logaritmico
+		uint32_t lat = (t0 - getMsgBlock(msg)->ts) >> 4;
+		uint8_t b = 0;
+		while(lat && b < LatencyBuckets - 1){
+			lat >>= 1;
+			b++;
+		}
+		_metrics.latency[b]++;
+	}
+	uint32_t sig = (msg)? msg->sig : 0;
+	run(oe);
+	uint32_t dt = us_ticker_read() - t0;
+	_metrics.dispatched++;
+	if(_trace && msg){
+		_trace->record(TraceRecorder::RecDispatch, sig, NULL, 0, dt, traceState());
+	}
+	if(msg){
+		uint16_t i = 0;
+		while(i < _metrics.num_signals && _metrics.signals[i].sig != sig){
+			i++;
+		}
+		if(i == _metrics.num_signals && i < MaxSignalMetrics){
+			_metrics.signals[i].sig = sig;
+			_metrics.signals[i].count = 0;
+			_metrics.signals[i].total_us = 0;
+			_metrics.signals[i].max_us = 0;
+			_metrics.num_signals++;
+		}
+		if(i < MaxSignalMetrics){
+			SignalMetrics& sm = _metrics.signals[i];
+			sm.count++;
+			sm.total_us += dt;
+			if(dt > sm.max_us){
+				sm.max_us = dt;
+			}
+		}
+	}
+	// libera los mensajes gestionados una vez procesados
+	if(managed){
+		releaseMessage(msg);
+	}
+}
+
+
 
 //------------------------------------------------------------------------------------
 osEvent ActiveModule::getOsEvent(){
-	uint32_t millis = (_wdt_handled)? _wdt_millis : osWaitForever;
 	osEvent oe;
 	do{
-		oe = _queue.get(millis);
-		// si est� habilitada la notificaci�n al task_watchdog...
-		if(_wdt_handled){
-			// publica keepalive
-			int32_t err = MQ::SUCCESS;
-			if((err = MQ::MQClient::publish(_wdt_topic, _wdt_name, strlen(_wdt_name)+1, &_publicationCb)) != MQ::SUCCESS){
-				DEBUG_TRACE_E(_EXPR_, _MODULE_, "Error publicando %s desde %s", _wdt_topic, _wdt_name);
-			}
+		oe = mailboxGet(periodicWait());
+		periodicTasks();
+		if(oe.status == osEventTimeout){
+			_metrics.wait_timeouts++;
 		}
 	}while (oe.status == osEventTimeout);
-	_queue_count--;
-	if(_queue_count < 0){
-		_queue_count = 0;
-	}
 	return oe;
 }
 
+
+//------------------------------------------------------------------------------------
+uint32_t ActiveModule::periodicWait(){
+	uint32_t millis = (_wdt_handled)? _wdt_millis : osWaitForever;
+	if(_metrics_period && _metrics_period < millis){
+		millis = _metrics_period;
+	}
+	if(_param_cache){
+		uint32_t flush = _param_cache->millisToFlush();
+		if(flush < millis){
+			millis = flush;
+		}
+	}
+	return millis;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::periodicTasks(){
+	// si est� habilitada la notificaci�n al task_watchdog...
+	if(_wdt_handled){
+		heartbeat();
+	}
+	if(_metrics_period){
+		publishMetrics();
+	}
+	if(_param_cache){
+		_param_cache->flushIfDue();
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::getMetrics(Metrics& metrics){
+	metrics.version = MetricsVersion;
+	int32_t count = _queue_count;
+	metrics.queue_depth = (count > 0)? count : 0;
+	metrics.queue_max_depth = _metrics.queue_max_depth;
+	metrics.dispatched = _metrics.dispatched;
+	metrics.wait_timeouts = _metrics.wait_timeouts;
+	metrics.rejected = _overload.rejected;
+	metrics.timeouts = _overload.timeouts;
+	metrics.dropped = _overload.dropped;
+	metrics.replaced = _overload.replaced;
+	memcpy(metrics.latency, _metrics.latency, sizeof(metrics.latency));
+	metrics.num_signals = _metrics.num_signals;
+	memcpy(metrics.signals, _metrics.signals, _metrics.num_signals * sizeof(SignalMetrics));
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::resetMetrics(){
+	_metrics.queue_max_depth = 0;
+	_metrics.dispatched = 0;
+	_metrics.wait_timeouts = 0;
+	memset(_metrics.latency, 0, sizeof(_metrics.latency));
+	_metrics.num_signals = 0;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::publishMetrics(){
+	uint32_t now = TaskHeartbeat::now();
+	if(now - _metrics_last < _metrics_period || !_pub_topic_base){
+		return;
+	}
+	_metrics_last = now;
+	if(!_metrics_topic.name){
+		_metrics_topic = createPubTopic("stat/metrics");
+	}
+	Metrics* m = (Metrics*)RefBuffer::create(sizeof(Metrics));
+	if(!m){
+		return;
+	}
+	getMetrics(*m);
+	// se publican unicamente las entradas de senal validas
+	uint16_t size = offsetof(Metrics, signals) + m->num_signals * sizeof(SignalMetrics);
+	int32_t err = MQ::MQClient::publish(_metrics_topic.name, m, size, &_publicationCb);
+	if(err != MQ::SUCCESS){
+		DEFERRED_TRACE_E(_EXPR_ISR_, _MODULE_, "Error publicando %s", _metrics_topic.name);
+	}
+	RefBuffer::release(m);
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::heartbeat(){
+	uint32_t now = TaskHeartbeat::now();
+	// marcando cada medio periodo se garantiza al menos una marca por periodo aunque la espera tenga retardos
+	if(now - _wdt_last < _wdt_millis / 2){
+		return;
+	}
+	_wdt_last = now;
+	if(_wdt_id >= 0){
+		TaskHeartbeat::beat(_wdt_id);
+	}
+	// publica keepalive (camino lento opcional)
+	if(_wdt_topic){
+		int32_t err = MQ::SUCCESS;
+		if((err = MQ::MQClient::publish(_wdt_topic, _wdt_name, _wdt_name_len, &_publicationCb)) != MQ::SUCCESS){
+			DEFERRED_TRACE_E(_EXPR_ISR_, _MODULE_, "Error publicando %s desde %s", _wdt_topic, _wdt_name);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------------
+ActiveModule::TopicHandle ActiveModule::createPubTopic(const char* suffix){
+	TopicHandle th;
+	MBED_ASSERT(_pub_topic_base);
+	th.len = strlen(_pub_topic_base) + 1 + strlen(suffix);
+	char* name = new char[th.len + 1]();
+	MBED_ASSERT(name);
+	sprintf(name, "%s/%s", _pub_topic_base, suffix);
+	th.name = name;
+	return th;
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t ActiveModule::publish(const TopicHandle& topic, void* data){
+	int32_t err = MQ::MQClient::publish(topic.name, data, RefBuffer::size(data), &_publicationCb);
+	if(err != MQ::SUCCESS){
+		DEFERRED_TRACE_E(_EXPR_ISR_, _MODULE_, "Error publicando en %s", topic.name);
+	}
+	RefBuffer::release(data);
+	return err;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::reserveTopics(uint16_t max_topics){
+	MBED_ASSERT(!_topic_map);
+	_topic_map = new TopicMap(max_topics);
+	MBED_ASSERT(_topic_map);
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t ActiveModule::registerTopic(const char* token, MQ::SubscribeCallback handler){
+	if(!_topic_map){
+		reserveTopics(DefaultMaxTopics);
+	}
+	int32_t id = _topic_map->add(token, handler);
+	if(id < 0){
+		DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERR_TOPIC No se puede registrar %s", token);
+	}
+	return id;
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t ActiveModule::getTopicId(const char* topic){
+	return (_topic_map)? _topic_map->find(topic, _sub_topic_base) : -1;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::dispatchTopic(const char* topic, void* msg, uint16_t msg_len){
+	int32_t id = getTopicId(topic);
+	if(id < 0){
+		return false;
+	}
+	_topic_map->handler(id).call(topic, msg, msg_len);
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::setMailboxType(MailboxType type){
+	_mbx_type = type;
+	if(_mbx_type == LockFreeMailbox && !_lf_lanes){
+		// reserva unica, alineada a la linea de cache que requiere MPSCQueue
+		uint8_t* mem = (uint8_t*)Heap::memAlloc(MaxLanes * sizeof(LockFreeLane) + MPSCQUEUE_CACHE_LINE);
+		MBED_ASSERT(mem);
+		mem = (uint8_t*)(((uintptr_t)mem + MPSCQUEUE_CACHE_LINE - 1) & ~(uintptr_t)(MPSCQUEUE_CACHE_LINE - 1));
+		_lf_lanes = (LockFreeLane*)mem;
+		for(uint8_t i = 0; i < MaxLanes; i++){
+			new (&_lf_lanes[i]) LockFreeLane();
+		}
+	}
+	for(uint8_t i = 0; i < MaxLanes; i++){
+		_lanes[i].limit = laneCapacity(i);
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+osStatus ActiveModule::mailboxPut(State::Msg* msg, uint8_t lane, uint32_t millis, bool evict){
+	Lane& ln = _lanes[lane];
+	uint64_t deadline = (millis && millis != osWaitForever)? Kernel::get_ms_count() + millis : 0;
+	uint32_t depth = ++ln.depth;
+	while(depth > ln.limit){
+		ln.depth--;
+		State::Msg* old;
+		// desde ISR no se descarta: liberar el mensaje antiguo puede requerir el heap
+		if(evict && !IS_ISR() && (old = laneTake(lane)) != NULL){
+			// descarta el mensaje mas antiguo del carril, liberando su posicion para el nuevo. Si el consumidor ya ha
+			// tomado su token, lo descartara al no encontrar el mensaje.
+			ln.depth--;
+			_queue_count--;
+			_mbx_sem.wait(0);
+			if(_pending_count){
+				pendingRemove(old);
+			}
+			_overload.dropped++;
+			disposeMessage(old);
+		}
+		else if(evict && !IS_ISR() && ln.depth < ln.limit){
+			// el consumidor u otro productor han liberado hueco entretanto
+		}
+		else{
+			uint64_t now = (deadline)? Kernel::get_ms_count() : 0;
+			if(millis == 0 || (deadline && now >= deadline)){
+				ln.rejects++;
+				return osErrorResource;
+			}
+			// espera a que el consumidor extraiga un mensaje del carril. El consumidor comprueba 'waiters' tras
+			// descontar la profundidad, por lo que se vuelve a comprobar esta tras anunciar la espera.
+			ln.waiters++;
+			if(ln.depth >= ln.limit){
+				ln.space.wait((deadline)? (uint32_t)(deadline - now) : osWaitForever);
+			}
+			ln.waiters--;
+		}
+		depth = ++ln.depth;
+	}
+	// el limite del carril no supera su capacidad, por lo que la insercion nunca bloquea al productor
+	osStatus ost;
+	if(_mbx_type == LockFreeMailbox){
+		ost = (_lf_lanes[lane].put(msg))? osOK : osErrorResource;
+	}
+	else if(lane == LaneUrgent){
+		ost = _urgent_queue.put(msg, 0);
+	}
+	else if(lane == LaneBackground){
+		ost = _background_queue.put(msg, 0);
+	}
+	else{
+		ost = _queue.put(msg, 0);
+	}
+	if(ost != osOK){
+		ln.depth--;
+		ln.rejects++;
+		return ost;
+	}
+	_mbx_sem.release();
+	ln.puts++;
+	uint32_t max = ln.max_depth;
+	while(depth > max && !ln.max_depth.compare_exchange_weak(max, depth));
+	return osOK;
+}
+
+
+//------------------------------------------------------------------------------------
+osEvent ActiveModule::mailboxGet(uint32_t millis){
+	osEvent oe;
+	for(;;){
+		// cada token corresponde a un mensaje publicado, pero en el mailbox lock-free un productor interrumpido puede
+		// tener reservada una posicion anterior todavia sin publicar, que impide extraerlo. El token se conserva y se
+		// espera al siguiente, que libera ese productor al completar la publicacion.
+		uint8_t lane;
+		State::Msg* msg = (_mbx_credit > 0)? laneGet(lane) : NULL;
+		if(!msg){
+			// sin mensajes en ningun carril, los tokens conservados son de mensajes descartados por PolicyDropOldest
+			if(_mbx_credit > 0 && _lanes[LaneUrgent].depth == 0 && _lanes[LaneNormal].depth == 0 && _lanes[LaneBackground].depth == 0){
+				_mbx_credit = 0;
+			}
+			if(_mbx_sem.wait(millis) <= 0){
+				oe.status = osEventTimeout;
+				oe.value.p = NULL;
+				return oe;
+			}
+			_mbx_credit++;
+			continue;
+		}
+		_mbx_credit--;
+		oe.status = osEventMessage;
+		oe.value.p = msg;
+		Lane& ln = _lanes[lane];
+		ln.depth--;
+		_queue_count--;
+		if(ln.waiters > 0){
+			ln.space.release();
+		}
+		if(_pending_count){
+			pendingRemove(msg);
+		}
+		return oe;
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+const ActiveModule::SignalPolicy& ActiveModule::getSignalPolicy(uint32_t sig){
+	for(uint8_t i = 0; i < MaxSignalPolicies && _sig_policies[i].sig != 0; i++){
+		if(_sig_policies[i].sig == sig){
+			return _sig_policies[i];
+		}
+	}
+	return _policy;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::pendingAdd(State::Msg* msg){
+	bool added = false;
+	core_util_critical_section_enter();
+	if(_pending_count < MaxPendingReplace){
+		_pending[_pending_count++] = msg;
+		added = true;
+	}
+	core_util_critical_section_exit();
+	return added;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::pendingRemove(State::Msg* msg){
+	core_util_critical_section_enter();
+	for(uint8_t i = 0; i < _pending_count; i++){
+		if(_pending[i] == msg){
+			_pending[i] = _pending[--_pending_count];
+			break;
+		}
+	}
+	core_util_critical_section_exit();
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::pendingReplace(State::Msg* msg){
+	if(!isManagedMessage(msg)){
+		return false;
+	}
+	MsgBlock* nb = getMsgBlock(msg);
+	uint8_t old_flags = 0;
+	void* old_data = NULL;
+	uint16_t old_size = 0;
+	bool found = false;
+	// la sustitucion se hace en seccion critica, ya que el consumidor retira el mensaje de _pending antes de procesarlo
+	core_util_critical_section_enter();
+	for(uint8_t i = 0; i < _pending_count; i++){
+		State::Msg* pm = _pending[i];
+		if(pm->sig != msg->sig || !isManagedMessage(pm) || getMsgBlock(pm)->key != nb->key){
+			continue;
+		}
+		MsgBlock* pb = getMsgBlock(pm);
+		// desde ISR solo se sustituyen datos cuya liberacion no requiere el heap (inline o de un bloque del pool)
+		if(IS_ISR() && !(pb->flags & MsgBlockInline) && pb->msg.msg && ((pb->flags & MsgBlockRefBuffer) || !_pool || !_pool->ownsBlock(pb->msg.msg, pb->size))){
+			break;
+		}
+		old_flags = pb->flags;
+		old_data = pb->msg.msg;
+		old_size = pb->size;
+		pb->flags &= ~(MsgBlockInline | MsgBlockRefBuffer);
+		if(nb->flags & MsgBlockInline){
+			memcpy(pb->data, nb->data, nb->size);
+			pb->msg.msg = pb->data;
+			pb->flags |= MsgBlockInline;
+		}
+		else{
+			pb->msg.msg = nb->msg.msg;
+			pb->flags |= (nb->flags & MsgBlockRefBuffer);
+		}
+		pb->size = nb->size;
+		found = true;
+		break;
+	}
+	core_util_critical_section_exit();
+	if(!found){
+		return false;
+	}
+	// libera los datos sustituidos y el contenedor del nuevo mensaje, cuyos datos ya no le pertenecen
+	if(old_flags & MsgBlockRefBuffer){
+		RefBuffer::release(old_data);
+	}
+	else if(!(old_flags & MsgBlockInline)){
+		memFree(old_data);
+		msgAccount(-(int32_t)old_size);
+	}
+	nb->flags = MsgBlockInline;
+	releaseMessage(msg);
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------
+State::Msg* ActiveModule::laneGet(uint8_t& lane){
+	State::Msg* msg;
+	// proteccion frente a inanicion: si el carril mas prioritario con mensajes ha sido atendido demasiadas veces
+	// seguidas teniendo otro inferior pendiente, se atiende a este
+	if(_starvation_limit){
+		int8_t high = -1, low = -1;
+		for(uint8_t i = 0; i < MaxLanes; i++){
+			if(_lanes[i].depth > 0){
+				if(high < 0){
+					high = i;
+				}
+				else{
+					low = i;
+					break;
+				}
+			}
+		}
+		if(low < 0){
+			_starvation_count = 0;
+		}
+		else if(++_starvation_count > _starvation_limit && (msg = laneTake(low)) != NULL){
+			_starvation_count = 0;
+			lane = low;
+			return msg;
+		}
+	}
+	for(uint8_t i = 0; i < MaxLanes; i++){
+		if((msg = laneTake(i)) != NULL){
+			lane = i;
+			return msg;
+		}
+	}
+	return NULL;
+}
+
+
+//------------------------------------------------------------------------------------
+State::Msg* ActiveModule::laneTake(uint8_t lane){
+	if(_mbx_type == LockFreeMailbox){
+		return _lf_lanes[lane].get();
+	}
+	osEvent oe;
+	if(lane == LaneUrgent){
+		oe = _urgent_queue.get(0);
+	}
+	else if(lane == LaneBackground){
+		oe = _background_queue.get(0);
+	}
+	else{
+		oe = _queue.get(0);
+	}
+	return (oe.status == osEventMessage)? (State::Msg*)oe.value.p : NULL;
+}
+
+
 //------------------------------------------------------------------------------------
 bool ActiveModule::saveParameter(const char* param_id, void* data, size_t size, NVSInterface::KeyValueType type){
+	if(_param_cache){
+		return _param_cache->save(param_id, data, size, type);
+	}
 	int err;
 	if(!_fs->open()){
 		DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERR_NVS No se puede abrir el sistema NVS");
@@ -157,6 +1139,9 @@ bool ActiveModule::saveParameter(const char* param_id, void* data, size_t size,
 
 //------------------------------------------------------------------------------------
 bool ActiveModule::restoreParameter(const char* param_id, void* data, size_t size, NVSInterface::KeyValueType type){
+	if(_param_cache){
+		return _param_cache->restore(param_id, data, size, type);
+	}
 	int err;
 	if(!_fs->open()){
 		DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERR_NVS No se puede abrir el sistema NVS");
@@ -174,6 +1159,9 @@ bool ActiveModule::restoreParameter(const char* param_id, void* data, size_t siz
 
 //------------------------------------------------------------------------------------
 bool ActiveModule::removeParameter(const char* param_id){
+	if(_param_cache){
+		return _param_cache->remove(param_id);
+	}
 	int err;
 	if(!_fs->open()){
 		DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERR_NVS No se puede abrir el sistema NVS");
@@ -188,3 +1176,358 @@ bool ActiveModule::removeParameter(const char* param_id){
 	_fs->close();
 	return ((err == osOK)? true : false);
 }
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::schemaRestore(const ConfigSchema& schema, void* cfg){
+	MBED_ASSERT(schema.num_fields <= ConfigSchema::MaxFields);
+	ConfigHeader hdr;
+	char key[ConfigSchema::MaxKeyLength + 1];
+	schemaKey(schema.key, key);
+	if(!restoreParameter(key, &hdr, sizeof(ConfigHeader), NVSInterface::TypeBlob) || hdr.version > schema.version){
+		DEBUG_TRACE_W(_EXPR_, _MODULE_, "ERR_CFG Sin configuracion valida en %s, establece por defecto", schema.key);
+		schemaSetDefaults(schema, cfg);
+		return false;
+	}
+	// los campos no presentes en la version grabada mantienen su valor por defecto
+	memcpy(cfg, schema.defaults, schema.size);
+	uint32_t mask = 0;
+	for(uint8_t i = 0; i < schema.num_fields; i++){
+		const ConfigField& f = schema.fields[i];
+		if(f.since > hdr.version){
+			mask |= (1 << i);
+			continue;
+		}
+		schemaKey(f.key, key);
+		if(!restoreParameter(key, (uint8_t*)cfg + f.offset, f.size, NVSInterface::TypeBlob)){
+			hdr.crc = ~schema.crc(cfg, hdr.version);
+			break;
+		}
+	}
+	if(schema.crc(cfg, hdr.version) != hdr.crc){
+		DEBUG_TRACE_W(_EXPR_, _MODULE_, "ERR_CFG CRC incorrecto en %s, establece por defecto", schema.key);
+		schemaSetDefaults(schema, cfg);
+		return false;
+	}
+	for(uint8_t i = 0; i < schema.num_fields; i++){
+		const ConfigField& f = schema.fields[i];
+		if(!ConfigSchema::inRange(f, cfg)){
+			memcpy((uint8_t*)cfg + f.offset, (const uint8_t*)schema.defaults + f.offset, f.size);
+			mask |= (1 << i);
+		}
+	}
+	// se toma como copia grabada la recuperada, de forma que solo se graben los campos migrados o reparados
+	if(!_cfg_shadow){
+		_cfg_shadow = (uint8_t*)Heap::memAlloc(schema.size);
+	}
+	if(_cfg_shadow){
+		memcpy(_cfg_shadow, cfg, schema.size);
+	}
+	if(mask || hdr.version != schema.version){
+		DEBUG_TRACE_I(_EXPR_, _MODULE_, "Migrando %s de v%d a v%d", schema.key, hdr.version, schema.version);
+		schemaWrite(schema, cfg, mask);
+	}
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::schemaSave(const ConfigSchema& schema, const void* cfg){
+	MBED_ASSERT(schema.num_fields <= ConfigSchema::MaxFields);
+	uint32_t mask = 0;
+	for(uint8_t i = 0; i < schema.num_fields; i++){
+		const ConfigField& f = schema.fields[i];
+		if(!_cfg_shadow || memcmp((const uint8_t*)cfg + f.offset, _cfg_shadow + f.offset, f.size) != 0){
+			mask |= (1 << i);
+		}
+	}
+	return (mask)? schemaWrite(schema, cfg, mask) : true;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::schemaSetDefaults(const ConfigSchema& schema, void* cfg){
+	memcpy(cfg, schema.defaults, schema.size);
+	uint32_t mask = (schema.num_fields >= 32)? 0xFFFFFFFF : ((1 << schema.num_fields) - 1);
+	schemaWrite(schema, cfg, mask);
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::schemaCheckIntegrity(const ConfigSchema& schema, void* cfg){
+	bool result = true;
+	for(uint8_t i = 0; i < schema.num_fields; i++){
+		const ConfigField& f = schema.fields[i];
+		if(!ConfigSchema::inRange(f, cfg)){
+			DEBUG_TRACE_W(_EXPR_, _MODULE_, "ERR_CFG Campo %s fuera de rango, establece por defecto", f.key);
+			memcpy((uint8_t*)cfg + f.offset, (const uint8_t*)schema.defaults + f.offset, f.size);
+			result = false;
+		}
+	}
+	if(!result){
+		schemaSave(schema, cfg);
+	}
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::reserveTimers(uint16_t max_timers){
+	if(!_timers && (_timers = TimerService::attach(max_timers, callback(this, &ActiveModule::timerExpired))) == NULL){
+		DEBUG_TRACE_E(_EXPR_, _MODULE_, "ERR_TIMER No se puede registrar la rueda de temporizacion");
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t ActiveModule::startTimer(uint32_t sig, uint32_t delay, uint32_t period){
+	if(!_timers){
+		reserveTimers(DefaultMaxTimers);
+		if(!_timers){
+			return -1;
+		}
+	}
+	int32_t id = TimerService::start(_timers, sig, delay, period);
+	if(id < 0){
+		DEFERRED_TRACE_E(_EXPR_ISR_, _MODULE_, "ERR_TIMER Sin temporizadores libres para la senal 0x%x", (int)sig);
+	}
+	return id;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::cancelTimer(int32_t id){
+	return (_timers)? TimerService::cancel(_timers, id) : false;
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t ActiveModule::call(ActiveModule* target, uint32_t sig, const void* data, uint16_t size, uint32_t reply_sig, uint32_t timeout){
+	// reserva una entrada en la tabla de llamadas pendientes
+	uint8_t slot = ACTIVEMODULE_MAX_CALLS;
+	uint32_t corr;
+	core_util_critical_section_enter();
+	do{
+		corr = ++_call_seq;
+	}while(corr == 0);
+	for(uint8_t i = 0; i < ACTIVEMODULE_MAX_CALLS; i++){
+		if(_calls[i].corr == 0){
+			_calls[i].corr = corr;
+			_calls[i].reply_sig = reply_sig;
+			_calls[i].timer_id = -1;
+			_calls[i].closing = false;
+			_calls[i].expired = false;
+			slot = i;
+			break;
+		}
+	}
+	core_util_critical_section_exit();
+	if(slot == ACTIVEMODULE_MAX_CALLS){
+		DEFERRED_TRACE_E(_EXPR_ISR_, _MODULE_, "ERR_CALL Sin espacio para la llamada 0x%x", (int)sig);
+		return 0;
+	}
+	if(timeout && (_calls[slot].timer_id = startTimer(CallTimeoutSig | slot, timeout)) < 0){
+		// sin temporizador la llamada podria no completarse nunca
+		core_util_critical_section_enter();
+		_calls[slot].corr = 0;
+		core_util_critical_section_exit();
+		return 0;
+	}
+	State::Msg* msg = target->newMessage(sig, data, size);
+	if(msg){
+		MsgBlock* blk = getMsgBlock(msg);
+		blk->corr = corr;
+		blk->reply_to = this;
+		// el llamante no espera por espacio en la cola del destino
+		if(target->postMessage(msg, false) == osOK){
+			return corr;
+		}
+	}
+	cancelCall(corr);
+	return 0;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::reply(const State::Msg* req, const void* data, uint16_t size){
+	if(!isManagedMessage(req) || !getMsgBlock(req)->reply_to){
+		return false;
+	}
+	MsgBlock* blk = getMsgBlock(req);
+	return blk->reply_to->deliverReply(blk->corr, data, size, false);
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::cancelCall(uint32_t corr){
+	uint32_t reply_sig;
+	uint8_t slot;
+	if(!callClaim(corr, false, reply_sig, slot)){
+		return false;
+	}
+	callRelease(slot, false);
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::schemaWrite(const ConfigSchema& schema, const void* cfg, uint32_t mask){
+	if(!_cfg_shadow && (_cfg_shadow = (uint8_t*)Heap::memAlloc(schema.size)) != NULL){
+		memcpy(_cfg_shadow, cfg, schema.size);
+	}
+	bool result = true;
+	char key[ConfigSchema::MaxKeyLength + 1];
+	for(uint8_t i = 0; i < schema.num_fields; i++){
+		const ConfigField& f = schema.fields[i];
+		if((mask & (1 << i)) == 0){
+			continue;
+		}
+		const uint8_t* data = (const uint8_t*)cfg + f.offset;
+		schemaKey(f.key, key);
+		if(!saveParameter(key, (void*)data, f.size, NVSInterface::TypeBlob)){
+			DEBUG_TRACE_W(_EXPR_, _MODULE_, "ERR_CFG No se pudo grabar el campo %s", f.key);
+			result = false;
+			// se fuerza la diferencia con la copia grabada para reintentarlo en la siguiente grabacion
+			if(_cfg_shadow){
+				_cfg_shadow[f.offset] = ~data[0];
+			}
+			continue;
+		}
+		if(_cfg_shadow){
+			memcpy(_cfg_shadow + f.offset, data, f.size);
+		}
+	}
+	// la cabecera se graba en ultimo lugar, de forma que un fallo intermedio se detecte por CRC al recuperar
+	ConfigHeader hdr = { schema.version, schema.num_fields, schema.crc(cfg, schema.version) };
+	schemaKey(schema.key, key);
+	if(!saveParameter(key, &hdr, sizeof(ConfigHeader), NVSInterface::TypeBlob)){
+		result = false;
+	}
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::schemaKey(const char* key, char* buf){
+	// el nombre se guarda como "[Name]....", la clave se forma sin decoracion
+	const char* name = &_name[1];
+	ConfigSchema::nvKey(name, strcspn(name, "]"), key, buf);
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::timerExpired(uint32_t sig){
+	// vencimiento de una llamada asincrona pendiente
+	if((sig & CallTimeoutMask) == CallTimeoutSig){
+		// la senal identifica la entrada, que no se libera hasta cancelar su temporizador (ver callRelease). Si esta
+		// reservada por una respuesta en curso, callClaim anota el vencimiento
+		uint32_t slot = sig & ~CallTimeoutMask;
+		uint32_t corr = 0;
+		core_util_critical_section_enter();
+		if(slot < ACTIVEMODULE_MAX_CALLS){
+			corr = _calls[slot].corr;
+		}
+		core_util_critical_section_exit();
+		if(corr){
+			deliverReply(corr, NULL, 0, true);
+		}
+		return;
+	}
+	// el thread de servicio es compartido: nunca espera por espacio en la cola del modulo
+	State::Msg* msg = newMessage(sig, 0);
+	if(msg){
+		postMessage(msg, false);
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::deliverReply(uint32_t corr, const void* data, uint16_t size, bool timeout){
+	uint32_t reply_sig;
+	uint8_t slot;
+	if(!callClaim(corr, timeout, reply_sig, slot)){
+		return false;
+	}
+	State::Msg* msg = newMessage(reply_sig, data, size);
+	if(msg){
+		MsgBlock* blk = getMsgBlock(msg);
+		blk->corr = corr;
+		if(timeout){
+			blk->flags |= MsgBlockTimeout;
+		}
+		// la respuesta llega desde el thread del modulo llamado o desde TimerService: nunca espera
+		if(postMessage(msg, false) == osOK){
+			callRelease(slot, timeout);
+			return true;
+		}
+	}
+	// sin memoria o cola llena: la llamada sigue pendiente, de forma que el llamante reciba al menos su vencimiento
+	DEFERRED_TRACE_E(_EXPR_ISR_, _MODULE_, "ERR_CALL No se puede entregar la %s de la llamada 0x%x", (timeout)? "expiracion" : "respuesta", (int)corr);
+	callRestore(slot, timeout);
+	return false;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ActiveModule::callClaim(uint32_t corr, bool timeout, uint32_t& reply_sig, uint8_t& slot){
+	bool claimed = false;
+	core_util_critical_section_enter();
+	for(uint8_t i = 0; i < ACTIVEMODULE_MAX_CALLS; i++){
+		if(_calls[i].corr != corr){
+			continue;
+		}
+		if(!_calls[i].closing){
+			_calls[i].closing = true;
+			reply_sig = _calls[i].reply_sig;
+			slot = i;
+			claimed = true;
+		}
+		else if(timeout){
+			// vencimiento durante la entrega de la respuesta: se reintenta si esta no llega a encolarse
+			_calls[i].expired = true;
+		}
+		break;
+	}
+	core_util_critical_section_exit();
+	return claimed;
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::callRelease(uint8_t slot, bool timeout){
+	int32_t timer_id = _calls[slot].timer_id;
+	if(!timeout && timer_id >= 0){
+		// TimerService::cancel espera a que termine un vencimiento en curso, tras ella la entrada puede reutilizarse
+		cancelTimer(timer_id);
+	}
+	core_util_critical_section_enter();
+	_calls[slot].closing = false;
+	_calls[slot].expired = false;
+	_calls[slot].corr = 0;
+	core_util_critical_section_exit();
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModule::callRestore(uint8_t slot, bool timeout){
+	for(;;){
+		// la entrada solo vuelve a pendiente si su temporizador sigue armado; un vencimiento anotado mientras se
+		// rearmaba (expired) obliga a repetir
+		core_util_critical_section_enter();
+		bool rearm = (timeout || _calls[slot].expired) && _calls[slot].timer_id >= 0;
+		_calls[slot].expired = false;
+		if(!rearm){
+			_calls[slot].closing = false;
+		}
+		core_util_critical_section_exit();
+		if(!rearm){
+			return;
+		}
+		timeout = false;
+		if((_calls[slot].timer_id = startTimer(CallTimeoutSig | slot, CallRetryMillis)) < 0){
+			DEFERRED_TRACE_E(_EXPR_ISR_, _MODULE_, "ERR_CALL Sin temporizador para la llamada 0x%x, se descarta", (int)_calls[slot].corr);
+			callRelease(slot, true);
+			return;
+		}
+	}
+}
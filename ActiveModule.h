@@ -5,6 +5,84 @@
  *  Author: raulMrello
  *
  *	Changelog: 
+ *	- @17Oct2026.039 StaticActiveModule resuelve su SignalTable en tiempo de compilacion en un array indexado por el
+ *	  bit de la senal, en lugar de recorrerla en cada despacho. Anado bench_static, que la instancia.
+ *	- @17Oct2026.038 Documento que los topics base y start() liberan el arranque del modulo y deben asignarse tras
+ *	  su construccion, no desde el constructor de la clase heredera (el estado inicial podria ejecutarse antes de
+ *	  inicializar sus miembros).
+ *	- @17Oct2026.037 TopicMap solo recurre a isTopicToken sobre los tokens con comodines, guardados aparte: un topic
+ *	  no registrado se resuelve con un hash y el recorrido de esos tokens, sin recorrer los tokens literales.
+ *	- @17Oct2026.036 El primer modulo crea el pool de RefBuffer (ACTIVEMODULE_REF_BUFFERS) si la aplicacion no ha
+ *	  asignado uno, y la plantilla y los modulos generados entregan los payloads binarios con newMessageRef, de forma
+ *	  que los RefBuffer publicados llegan al suscriptor sin copia. RefBuffer::isShared exige inicio de bloque.
+ *	- @17Oct2026.035 Una respuesta o vencimiento de call() que no se puede encolar en el llamante (sin memoria o cola
+ *	  llena) deja la llamada pendiente: se mantiene su vencimiento o, si ya ha vencido, se reintenta su entrega.
+ *	- @17Oct2026.034 StateTable resuelve la matriz de transiciones en tiempo de compilacion (StateTable::index) en
+ *	  lugar de en cada instancia. Anado MaxUserSignals como limite comun de senales de StateTable y build_spec.py.
+ *	- @17Oct2026.033 Si la busqueda por hash de TopicMap falla, se recurre a isTopicToken sobre todos los tokens
+ *	  registrados, manteniendo la semantica de subcadena de las cadenas isTopicToken que sustituye registerTopic.
+ *	- @17Oct2026.032 call() falla si no puede armar el temporizador de vencimiento. La senal de vencimiento identifica
+ *	  la entrada de la llamada, que se compara con su identificador completo y no se reutiliza hasta cancelar su
+ *	  temporizador.
+ *	- @17Oct2026.031 DeferredLog copia en la traza las cadenas transitorias marcadas con DeferredLog::copy o
+ *	  DEFERRED_STR. La plantilla y los modulos generados las utilizan para trazar el topic recibido.
+ *	- @17Oct2026.030 Las claves NV de ConfigSchema llevan el nombre del modulo como prefijo (ConfigSchema::nvKey),
+ *	  de forma que las claves del esquema son locales al modulo y no colisionan entre modulos.
+ *	- @17Oct2026.029 ActiveExecutor limita los modulos asociados a max_modules (el resto se ejecuta con thread
+ *	  propio) y encola periodicamente los modulos con tareas periodicas. attachToTaskWatchdog devuelve el resultado
+ *	  y falla en modo executor.
+ *	- @17Oct2026.028 Desde ISR los mensajes y sus datos nunca se reservan del heap (la reserva falla) y
+ *	  PolicyDropOldest rechaza en lugar de descartar, ya que el mensaje descartado puede tener datos en el heap.
+ *	- @17Oct2026.027 PolicyDropOldest descarta el mensaje mas antiguo del carril antes de insertar el nuevo, sin
+ *	  exceder la capacidad fisica. PolicyBlock espera en un semaforo del carril que libera el consumidor al extraer.
+ *	- @17Oct2026.026 El consumidor del mailbox ya no sondea con Thread::wait(1) cuando un productor lock-free tiene
+ *	  reservada una posicion sin publicar: conserva el token obtenido (_mbx_credit) y espera el siguiente, que libera
+ *	  ese productor al completar la publicacion.
+ *	- @17Oct2026.025 Cada carril del mailbox del RTOS tiene su propia cola (LaneNormal: DefaultMaxQueueMessages,
+ *	  LaneUrgent y LaneBackground: LaneQueueMessages), de forma que el limite de cada carril no supera su capacidad
+ *	  fisica. La extraccion y la proteccion frente a inanicion son comunes a ambos tipos de mailbox.
+ *	- @17Oct2026.024 Los mensajes gestionados se identifican por rango de direcciones: sus bloques se reservan
+ *	  siempre de un MsgPool (el del modulo o el compartido de ACTIVEMODULE_MSG_BLOCKS bloques), nunca del heap, de
+ *	  forma que isManagedMessage no lee memoria ajena a los mensajes no gestionados. dispatch decide si libera el
+ *	  mensaje antes de ejecutar el manejador.
+ *	- @17Oct2026.023 Anado maquina de estados declarativa opcional (StateTable.h) con despacho por tabla densa
+ *	  estado x senal, utilizable desde Init_EventHandler
+ *	- @17Oct2026.022 Anado informe de consumo maximo de pila, cola y memoria de mensajes (getMemoryReport) y su
+ *	  exportacion en JSON (exportMemoryReport) para dimensionar los modulos generados con build_impl.py
+ *	- @17Oct2026.021 Arranque por eventos: el thread espera en un semaforo liberado por los topics base, start() o
+ *	  las dependencias (dependsOn), en lugar de sondear cada 100ms. El constructor ya no espera al thread. Anado
+ *	  el tiempo de arranque (getStartupTime)
+ *	- @17Oct2026.020 Anado llamadas asincronas entre modulos (call, reply) con identificador de correlacion,
+ *	  respuesta entregada como senal en la cola del llamante y vencimiento opcional sobre los temporizadores
+ *	- @17Oct2026.019 Anado canales directos tipados entre modulos (DirectChannel.h) que postean en putMessage sin
+ *	  pasar por el broker, con replica opcional en un topic
+ *	- @17Oct2026.018 Anado senales fusionables (setSignalCoalescing): un mensaje con la misma senal (y clave, ver
+ *	  setMsgKey) que otro pendiente sustituye sus datos manteniendo su posicion en la cola
+ *	- @17Oct2026.017 Las trazas del camino critico (putMessage, newMessage, publicaciones periodicas) se encolan en
+ *	  el backend diferido DeferredLog en lugar de formatearse en el thread del modulo
+ *	- @17Oct2026.016 Anado registro binario opcional de mensajes encolados y despachados (enableTrace, dumpTrace)
+ *	  reproducible con TraceReplay
+ *	- @17Oct2026.015 El manejador de mensajes de la maquina de estados se aloja en el propio modulo (_msg_handler)
+ *	  en lugar de en el heap. Anado la variante estatica StaticActiveModule (ver StaticActiveModule.h).
+ *	- @17Oct2026.014 Anado temporizadores de senales diferidas y periodicas (startTimer, cancelTimer) sobre una rueda
+ *	  de temporizacion jerarquica por modulo, avanzada por el thread compartido TimerService
+ *	- @17Oct2026.013 Anado esquema de configuracion (ConfigSchema) con version, CRC, migracion y grabacion de los
+ *	  campos modificados unicamente (schemaRestore, schemaSave, schemaSetDefaults, schemaCheckIntegrity)
+ *	- @17Oct2026.012 Anado cache de parametros NV con escritura diferida (attachParamCache, flushParameters)
+ *	- @17Oct2026.011 Anado metricas por modulo (getMetrics) y su publicacion periodica opcional. _queue_count y
+ *	  _max_queue_count pasan a ser atomicos.
+ *	- @17Oct2026.010 Anado modo de ejecucion sobre ActiveExecutor (threads de trabajo compartidos entre modulos)
+ *	- @17Oct2026.009 El keepalive del TaskWatchdog se registra en TaskHeartbeat como maximo una vez por periodo; la
+ *	  publicacion MQ pasa a ser opcional (wdg_topic != NULL) y con la misma limitacion de cadencia.
+ *	- @17Oct2026.008 Anado procesado por lotes (setBatchSize) con notificacion de inicio y fin de lote
+ *	- @17Oct2026.007 Anado politicas de sobrecarga en putMessage por modulo y por senal. putMessage siempre toma
+ *	  la propiedad del mensaje y lo libera si no puede encolarlo.
+ *	- @17Oct2026.006 Anado carriles de prioridad (MsgLane) en el mailbox con limite de profundidad y estadisticas
+ *	- @17Oct2026.005 Anado despacho de topics suscritos por tabla hash (registerTopic, dispatchTopic)
+ *	- @17Oct2026.004 Anado publicacion sin copias mediante RefBuffer y topics preformateados (TopicHandle)
+ *	- @17Oct2026.003 Anado mensajes gestionados (newMessage) con datos inline y liberacion automatica tras run()
+ *	- @17Oct2026.002 Anado gestor de bloques MsgPool para mensajes y datos asociados (memAlloc/memFree)
+ *	- @17Oct2026.001 Anado mailbox lock-free (MPSCQueue) seleccionable por modulo mediante setMailboxType
  *	- @7Mar2018.001 Habilito DefaultPutTimeout para evitar dead-locks ocultos en mutex.lock
  *	- @14Feb2018.001 Cambio 'ready=true' una vez que se haya completado el evento Init::EV_ENTRY.
  *
@@ -22,6 +100,45 @@
 #include "StateMachine.h"
 #include "MQLib.h"
 #include "FSManager.h"
+#include "MPSCQueue.h"
+#include "MsgPool.h"
+#include "RefBuffer.h"
+#include "TopicMap.h"
+#include "TaskHeartbeat.h"
+#include "ActiveExecutor.h"
+#include "ParamCache.h"
+#include "ConfigSchema.h"
+#include "TimerService.h"
+#include "TraceRecorder.h"
+#include "DeferredLog.h"
+#include <atomic>
+
+/** Tamano maximo de los datos que se alojan dentro del propio bloque de mensaje (newMessage). Los datos de mayor
+ *  tamano se alojan en un bloque independiente. */
+#ifndef ACTIVEMODULE_INLINE_PAYLOAD
+#define ACTIVEMODULE_INLINE_PAYLOAD		32
+#endif
+
+/** Numero de bloques del pool compartido de mensajes gestionados, utilizado por los modulos sin MsgPool propio
+ *  (o con su pool agotado) */
+#ifndef ACTIVEMODULE_MSG_BLOCKS
+#define ACTIVEMODULE_MSG_BLOCKS			32
+#endif
+
+/** Numero de buffers y tamano maximo de sus datos del pool de RefBuffer que se crea con el primer modulo si la
+ *  aplicacion no ha asignado uno (RefBuffer::setPool). Los buffers mayores, o con el pool agotado, se reservan del
+ *  heap y los suscriptores los copian. Con ACTIVEMODULE_REF_BUFFERS = 0 no se crea el pool. */
+#ifndef ACTIVEMODULE_REF_BUFFERS
+#define ACTIVEMODULE_REF_BUFFERS		8
+#endif
+#ifndef ACTIVEMODULE_REF_BUFFER_SIZE
+#define ACTIVEMODULE_REF_BUFFER_SIZE	128
+#endif
+
+/** Maximo numero de llamadas asincronas (call) pendientes de respuesta por modulo */
+#ifndef ACTIVEMODULE_MAX_CALLS
+#define ACTIVEMODULE_MAX_CALLS			8
+#endif
 
 class ActiveModule : public StateMachine {
   public:
@@ -34,6 +151,19 @@ class ActiveModule : public StateMachine {
     ActiveModule(const char* name, osPriority priority=osPriorityNormal, uint32_t stack_size = OS_STACK_SIZE, FSManager* fs = NULL, bool defdbg = false);
 
 
+    /** Constructor para ejecutar el modulo sobre un ActiveExecutor compartido, sin thread propio. Los manejadores
+     *  siguen ejecutandose de forma serializada, pero no deben bloquear, ya que ocupan un thread compartido. En este
+     *  modo no se admite attachToTaskWatchdog (el modulo no dispone de thread que vigilar). Si el executor ya tiene
+     *  su maximo de modulos, el modulo se ejecuta con thread propio de OS_STACK_SIZE.
+     *  @param name Nombre del m�dulo
+     *  @param executor Executor que ejecuta el modulo
+     *  @param priority Prioridad del modulo dentro del executor
+     *  @param fs Gestor del sistema de backup en memoria NVS
+     *  @param defdbg Flag para habilitar depuracion por defecto
+     */
+    ActiveModule(const char* name, ActiveExecutor* executor, osPriority priority=osPriorityNormal, FSManager* fs = NULL, bool defdbg = false);
+
+
     /** Destructor
      */
     virtual ~ActiveModule(){}
@@ -52,39 +182,462 @@ class ActiveModule : public StateMachine {
   
   
     /** Configura el topic base para la publicaci�n de mensajes
+     *  Libera el arranque del modulo (ver startupNotify): no debe invocarse desde el constructor de la clase
+     *  heredera, ya que el estado inicial podria ejecutarse antes de que se inicialicen sus miembros. Se asigna
+     *  tras construir el modulo.
      *  @param pub_topic_base Topic base para la publicaci�n
      */
     void setPublicationBase(const char* pub_topic_base){
     	_pub_topic_base = pub_topic_base;
+    	startupNotify();
     }
     
 
     /** Configura el topic base para la suscripci�n de mensajes
+     *  Libera el arranque del modulo, por lo que tampoco debe invocarse desde el constructor de la clase heredera.
      *  @param sub_topic_base Topic base para la suscripci�n
      */
     void setSubscriptionBase(const char* sub_topic_base){
     	_sub_topic_base = sub_topic_base;
+    	startupNotify();
+    }
+
+
+    /** Fuerza el arranque del modulo sin esperar a que se asignen los topics base (modulos que no utilizan el
+     *  broker). El arranque sigue esperando a sus dependencias (dependsOn). Como los topics base, se invoca tras
+     *  construir el modulo, nunca desde el constructor de la clase heredera.
+     */
+    void start(){
+    	_start_forced = true;
+    	startupNotify();
     }
 
 
-    /** Registra su operativa en el gestor watchdog de tareas
+    /** Maximo numero de senales de usuario (State::EV_RESERVED_USER << i, i < MaxUserSignals). Limite comun de
+     *  StateTable y de los modulos generados por build_spec.py.
+     */
+    static const uint8_t MaxUserSignals = 32 - __builtin_ctz((uint32_t)State::EV_RESERVED_USER);
+
+
+    /** Maximo numero de dependencias y de modulos dependientes por modulo */
+    static const uint8_t MaxDependencies = 4;
+
+
+    /** Declara una dependencia de arranque: el estado inicial (Init EV_ENTRY) no se ejecuta hasta que el modulo
+     *  dep haya completado el suyo. Los modulos sin dependencias entre si arrancan en paralelo. Debe invocarse
+     *  antes de asignar los topics base (o de start).
+     *  @param dep Modulo del que depende
+     *  @return True: registrada, False: sin espacio en la tabla de dependencias de alguno de los modulos
+     */
+    bool dependsOn(ActiveModule* dep);
+
+
+    /** Chequea si el modulo ha completado su estado inicial (Init EV_ENTRY)
+     *  @return True: iniciado
+     */
+    bool isStarted() { return _started; }
+
+
+    /** Obtiene el tiempo de arranque del modulo, desde su construccion hasta completar Init EV_ENTRY
+     *  @return Milisegundos (0: no iniciado)
+     */
+    uint32_t getStartupTime() { return (_started)? _startup_ms : 0; }
+
+
+    /** Obtiene la prioridad del modulo
+     *  @return Prioridad
+     */
+    osPriority getPriority() { return _priority; }
+
+
+    /** Registra su operativa en el gestor watchdog de tareas. La actividad se marca en la tabla TaskHeartbeat
+     *  como maximo una vez cada millis/2, y opcionalmente se publica tambien en wdg_topic con la misma cadencia.
      * 	@param millis Temporizaci�n para enviar el ping de actividad
-     * 	@param wdg_topic Topic en el que publicar la notificaci�n de actividad
+     * 	@param wdg_topic Topic en el que publicar la notificaci�n de actividad (NULL: solo TaskHeartbeat)
      * 	@param name Nombre utilizado para publicar
+     * 	@return False si no se ha podido registrar o si el modulo se ejecuta en un ActiveExecutor
      */
-    void attachToTaskWatchdog(uint32_t millis, const char* wdg_topic, const char* name);
+    bool attachToTaskWatchdog(uint32_t millis, const char* wdg_topic, const char* name);
 
 
-    /** Interfaz para postear un mensaje de la m�quina de estados en el Mailbox de la clase heredera
+    /** Interfaz para postear un mensaje de la m�quina de estados en el Mailbox de la clase heredera. Aplica la
+     *  politica de sobrecarga de la senal del mensaje (o la del modulo). El mensaje pasa a ser propiedad del modulo:
+     *  si no puede encolarse, se libera.
      *  @param msg Mensaje a postear
      *  @return Resultado
      */
     virtual osStatus putMessage(State::Msg *msg);
 
 
+    /** Postea un mensaje en un carril de prioridad concreto. Solo los mensajes gestionados (newMessage) guardan
+     *  su carril; el resto se postean siempre en LaneNormal.
+     *  @param msg Mensaje a postear
+     *  @param lane Carril de prioridad
+     *  @return Resultado
+     */
+    osStatus putMessage(State::Msg *msg, uint8_t lane);
+
+
+    /** Asigna el gestor de bloques utilizado para los mensajes y sus datos. Puede ser propio del modulo
+     *  o compartido entre varios modulos. Sin gestor asignado, los datos se reservan del heap. Los bloques de los
+     *  mensajes gestionados (MsgBlockSize) se reservan de una clase de este gestor o, si no la tiene o esta agotada,
+     *  del pool compartido de ACTIVEMODULE_MSG_BLOCKS bloques; nunca del heap.
+     *  @param pool Gestor de bloques
+     */
+    void setMsgPool(MsgPool* pool){
+    	_pool = pool;
+    }
+
+
+    /** Crea un mensaje gestionado por el modulo, con espacio para 'size' bytes de datos accesibles en msg->msg.
+     *  Los datos de hasta InlinePayloadSize bytes se alojan en el propio bloque del mensaje. El mensaje se libera
+     *  automaticamente una vez procesado por la maquina de estados, por lo que los manejadores NO deben liberarlo.
+     *  Desde ISR los datos que no caben en el bloque requieren una clase del MsgPool del modulo: nunca se recurre
+     *  al heap.
+     *  @param sig Senal (evento) asociada
+     *  @param size Tamano de los datos (0: sin datos, msg->msg = NULL)
+     *  @return Mensaje o NULL si no hay memoria o bloques libres (ver setMsgPool)
+     */
+    State::Msg* newMessage(uint32_t sig, uint16_t size = 0);
+
+
+    /** Crea un mensaje gestionado copiando los datos indicados
+     *  @param sig Senal (evento) asociada
+     *  @param data Datos a copiar
+     *  @param size Tamano de los datos
+     *  @return Mensaje o NULL si no hay memoria
+     */
+    State::Msg* newMessage(uint32_t sig, const void* data, uint16_t size);
+
+
+    /** Crea un mensaje gestionado a partir de unos datos recibidos en subscriptionCb. Si los datos son un
+     *  RefBuffer compartible se retienen sin copiarlos; en otro caso se copian como en newMessage.
+     *  @param sig Senal (evento) asociada
+     *  @param data Datos recibidos
+     *  @param size Tamano de los datos
+     *  @return Mensaje o NULL si no hay memoria
+     */
+    State::Msg* newMessageRef(uint32_t sig, void* data, uint16_t size);
+
+
+    /** Libera un mensaje gestionado (creado con newMessage). Los mensajes no gestionados se ignoran.
+     *  @param msg Mensaje
+     */
+    void releaseMessage(State::Msg* msg);
+
+
+    /** Chequea si un mensaje ha sido creado con newMessage. Se comprueba por rango de direcciones antes de acceder
+     *  a la cabecera, de forma que admite cualquier mensaje.
+     *  @param msg Mensaje
+     *  @return True si es un mensaje gestionado
+     */
+    static bool isManagedMessage(const State::Msg* msg){
+    	return (blockOwner(msg) != NULL);
+    }
+
+
+    /** Obtiene los datos de un mensaje con el tipo indicado
+     *  @param msg Mensaje
+     *  @return Datos o NULL si el mensaje es gestionado y sus datos son menores que T
+     */
+    template<typename T>
+    static T* getMsgData(State::Msg* msg){
+    	if(isManagedMessage(msg) && getMsgBlock(msg)->size < sizeof(T)){
+    		return NULL;
+    	}
+    	return (T*)msg->msg;
+    }
+
+
+    /** Obtiene el tamano de los datos de un mensaje gestionado
+     *  @param msg Mensaje
+     *  @return Tamano de los datos (0 si no es gestionado)
+     */
+    static uint16_t getMsgSize(const State::Msg* msg){
+    	return (isManagedMessage(msg))? getMsgBlock(msg)->size : 0;
+    }
+
+
+    /** Asigna la clave de fusion de un mensaje gestionado (ver setSignalCoalescing). Solo se fusionan mensajes
+     *  con la misma senal y clave (por defecto 0).
+     *  @param msg Mensaje
+     *  @param key Clave (ej. identificador del sensor o del parametro)
+     */
+    static void setMsgKey(State::Msg* msg, uint32_t key){
+    	if(isManagedMessage(msg)){
+    		getMsgBlock(msg)->key = key;
+    	}
+    }
+
+
+    /** Obtiene el identificador de correlacion de una peticion (call) o de su respuesta
+     *  @param msg Mensaje
+     *  @return Identificador de correlacion (0: no es una peticion ni una respuesta)
+     */
+    static uint32_t getMsgCorrId(const State::Msg* msg){
+    	return (isManagedMessage(msg))? getMsgBlock(msg)->corr : 0;
+    }
+
+
+    /** Chequea si una respuesta corresponde al vencimiento de la llamada (sin datos)
+     *  @param msg Mensaje de respuesta
+     *  @return True: la llamada ha vencido sin respuesta
+     */
+    static bool isCallTimeout(const State::Msg* msg){
+    	return isManagedMessage(msg) && (getMsgBlock(msg)->flags & MsgBlockTimeout) != 0;
+    }
+
+
+
+    /** Tipos de mailbox disponibles para la cola de mensajes del modulo */
+    enum MailboxType{
+    	RtosMailbox = 0,		/// Queue del RTOS (por defecto)
+		LockFreeMailbox,		/// Cola MPSCQueue lock-free, utilizable desde ISR
+    };
+
+
+    /** Carriles de prioridad del mailbox. Siempre se extraen antes los mensajes de los carriles mas prioritarios. */
+    enum MsgLane{
+    	LaneUrgent = 0,			/// Comandos criticos
+		LaneNormal,				/// Carril por defecto
+		LaneBackground,			/// Telemetria y tareas de baja prioridad
+		MaxLanes
+    };
+
+
+    /** Estadisticas de un carril de prioridad */
+    struct LaneStats {
+    	uint32_t depth;							/// Mensajes pendientes
+    	uint32_t max_depth;						/// Maximo de mensajes pendientes
+    	uint32_t puts;							/// Mensajes aceptados
+    	uint32_t rejects;						/// Mensajes rechazados por limite de profundidad o mailbox lleno
+    };
+
+
+    /** Politicas de actuacion cuando un mensaje no cabe en su carril */
+    enum OverloadPolicy{
+    	PolicyBlock = 0,		/// Bloquea al productor como maximo el tiempo indicado (no aplica desde ISR)
+		PolicyReject,			/// Rechaza el mensaje inmediatamente
+		PolicyDropOldest,		/// Descarta el mensaje mas antiguo del carril (rechaza si no hay ninguno publicado o desde ISR)
+		PolicyReplace,			/// Sustituye los datos del mensaje pendiente con la misma senal (ultimo valor)
+    };
+
+
+    /** Estadisticas de sobrecarga */
+    struct OverloadStats {
+    	uint32_t rejected;						/// Mensajes rechazados y liberados
+    	uint32_t timeouts;						/// Rechazos tras agotar la espera de PolicyBlock
+    	uint32_t dropped;						/// Mensajes antiguos descartados (PolicyDropOldest)
+    	uint32_t replaced;						/// Mensajes sustituidos (PolicyReplace)
+    	uint32_t merged;						/// Mensajes fusionados con uno pendiente (setSignalCoalescing)
+    };
+
+
+    /** Establece la politica de sobrecarga por defecto del modulo (por defecto PolicyBlock con DefaultPutTimeout)
+     *  @param policy Politica
+     *  @param millis Tiempo maximo de espera en PolicyBlock
+     */
+    void setOverloadPolicy(OverloadPolicy policy, uint32_t millis = DefaultPutTimeout){
+    	_policy.policy = policy;
+    	_policy.millis = millis;
+    }
+
+
+    /** Establece la politica de sobrecarga de una senal concreta
+     *  @param sig Senal
+     *  @param policy Politica
+     *  @param millis Tiempo maximo de espera en PolicyBlock
+     *  @return True: asignada, False: no hay espacio en la tabla de politicas
+     */
+    bool setSignalPolicy(uint32_t sig, OverloadPolicy policy, uint32_t millis = DefaultPutTimeout);
+
+
+    /** Marca una senal como fusionable ("el ultimo valor prevalece"). Al postear un mensaje gestionado con esta
+     *  senal, si hay otro pendiente en la cola con la misma senal y clave (ver setMsgKey), se sustituyen sus datos
+     *  (liberando los anteriores) manteniendo su posicion, en lugar de encolar un mensaje nuevo.
+     *  @param sig Senal
+     *  @param enable True: fusionable, False: se encola cada mensaje
+     *  @return True: asignada, False: no hay espacio en la tabla de politicas
+     */
+    bool setSignalCoalescing(uint32_t sig, bool enable = true);
+
+
+    /** Obtiene las estadisticas de sobrecarga
+     *  @param stats Receptor de las estadisticas
+     */
+    void getOverloadStats(OverloadStats& stats);
+
+
+    /** Numero de intervalos del histograma de latencia. El intervalo i cuenta las latencias menores de 2^(i+4) us,
+     *  y el ultimo todas las mayores. */
+    static const uint8_t LatencyBuckets = 12;
+
+    /** Maximo numero de senales con metricas propias */
+    static const uint8_t MaxSignalMetrics = 16;
+
+    /** Version del formato de Metrics (publicado en binario) */
+    static const uint16_t MetricsVersion = 1;
+
+    /** Metricas de ejecucion de una senal */
+    struct SignalMetrics {
+    	uint32_t sig;							/// Senal
+    	uint32_t count;							/// Mensajes procesados
+    	uint32_t total_us;						/// Tiempo acumulado en los manejadores
+    	uint32_t max_us;						/// Tiempo maximo en los manejadores
+    };
+
+    /** Metricas del modulo. Se publican en binario hasta signals[num_signals-1]. */
+    struct Metrics {
+    	uint16_t version;						/// MetricsVersion
+    	uint16_t num_signals;					/// Entradas validas en signals
+    	uint32_t queue_depth;					/// Mensajes pendientes
+    	uint32_t queue_max_depth;				/// Maximo de mensajes pendientes
+    	uint32_t dispatched;					/// Mensajes procesados
+    	uint32_t wait_timeouts;					/// Esperas del thread finalizadas sin mensaje
+    	uint32_t rejected;						/// Ver OverloadStats
+    	uint32_t timeouts;
+    	uint32_t dropped;
+    	uint32_t replaced;
+    	uint32_t latency[LatencyBuckets];		/// Histograma de latencia encolado-despacho (mensajes gestionados)
+    	SignalMetrics signals[MaxSignalMetrics];	/// Tiempos de ejecucion por senal
+    };
+
+
+    /** Obtiene una copia de las metricas del modulo
+     *  @param metrics Receptor de las metricas
+     */
+    void getMetrics(Metrics& metrics);
+
+
+    /** Reinicia las metricas del modulo (excepto la profundidad actual de la cola)
+     */
+    void resetMetrics();
+
+
+    /** Habilita la publicacion periodica de las metricas en binario (struct Metrics) en el topic
+     *  "<pub_topic_base>/stat/metrics"
+     *  @param millis Periodo de publicacion (0: deshabilitada)
+     */
+    void enableMetricsPublication(uint32_t millis){
+    	_metrics_period = millis;
+    }
+
+
+    /** Obtiene las estadisticas de un carril
+     *  @param lane Carril
+     *  @param stats Receptor de las estadisticas
+     */
+    void getLaneStats(uint8_t lane, LaneStats& stats);
+
+
+    /** Informe de consumo maximo de recursos del modulo */
+    struct MemoryReport {
+    	uint32_t stack_size;					/// Tamano de la pila del thread (0 en modo executor)
+    	uint32_t stack_max;						/// Maximo de pila utilizada
+    	uint32_t queue_size;					/// Limite de mensajes del carril LaneNormal
+    	uint32_t queue_max;						/// Maximo de mensajes pendientes (ver getMetrics)
+    	uint32_t msg_bytes;						/// Bytes de mensajes gestionados y sus datos reservados actualmente
+    	uint32_t msg_bytes_max;					/// Maximo de bytes de mensajes gestionados y sus datos
+    };
+
+
+    /** Obtiene el informe de consumo maximo de recursos del modulo
+     *  @param report Receptor del informe
+     */
+    void getMemoryReport(MemoryReport& report);
+
+
+    /** Exporta el informe de consumo en una linea JSON, interpretable por class_impl/build_impl.py (-r) para
+     *  generar las constantes de dimensionado del modulo. Ej:
+     *  {"module":"Name","stack_size":4096,"stack_max":1320,"queue_size":16,"queue_max":5,"msg_bytes_max":480}
+     *  @param buf Buffer de salida
+     *  @param len Tamano del buffer
+     *  @return Longitud de la linea (como snprintf)
+     */
+    int exportMemoryReport(char* buf, size_t len);
+
+
+    /** Habilita el registro binario de los mensajes encolados y despachados (ver TraceRecorder)
+     *  @param records Numero de registros del buffer circular (potencia de 2)
+     */
+    void enableTrace(uint32_t records);
+
+
+    /** Vuelca el registro binario en un fichero, decodificable con tools/trace_decode.py
+     *  @param f Fichero de salida
+     *  @return Numero de registros volcados
+     */
+    uint32_t dumpTrace(FILE* f);
+
+
+    /** Topic de publicacion preformateado con el topic base de publicacion */
+    struct TopicHandle {
+    	const char* name;						/// Topic completo
+    	uint16_t len;							/// Longitud del topic
+    };
+
+
+    /** Tamano de los datos alojables dentro del bloque de mensaje */
+    static const uint16_t InlinePayloadSize = ACTIVEMODULE_INLINE_PAYLOAD;
+
+
+    /** Bloque de un mensaje gestionado. La cabecera precede a State::Msg, de forma que el resto del sistema
+     *  sigue viendo un State::Msg* convencional.
+     */
+    struct MsgBlock {
+    	uint32_t tag;							/// MsgBlockTag ^ direccion del bloque (identifica mensajes gestionados)
+    	uint16_t size;							/// Tamano de los datos
+    	uint8_t flags;							/// Flags MsgBlockFlags
+    	uint8_t lane;							/// Carril de prioridad (MsgLane)
+    	uint32_t ts;							/// Instante de encolado (us)
+    	uint32_t key;							/// Clave de fusion (setMsgKey)
+    	uint32_t corr;							/// Identificador de correlacion (call/reply)
+    	ActiveModule* reply_to;					/// Modulo al que responder (peticiones de call)
+    	State::Msg msg;							/// Mensaje entregado a la maquina de estados
+    	MBED_ALIGN(8) uint8_t data[InlinePayloadSize];	/// Datos inline
+    };
+
+    /** Tamano del bloque de un mensaje gestionado (util para dimensionar un MsgPool) */
+    static const uint16_t MsgBlockSize = sizeof(MsgBlock);
+
+
   protected:
-    int32_t _queue_count;
-    static int32_t _max_queue_count;
+
+    /** Marca de los bloques de mensajes gestionados */
+    static const uint32_t MsgBlockTag = 0x4D534742;
+
+    /** Flags de los bloques de mensajes gestionados */
+    enum MsgBlockFlags{
+    	MsgBlockInline = (1 << 0),			/// Los datos se alojan en MsgBlock::data
+    	MsgBlockRefBuffer = (1 << 1),		/// Los datos son un RefBuffer retenido
+    	MsgBlockTimeout = (1 << 2),			/// Respuesta generada por vencimiento de la llamada
+    };
+
+    /** Obtiene el bloque asociado a un mensaje gestionado
+     *  @param msg Mensaje
+     *  @return Bloque
+     */
+    static MsgBlock* getMsgBlock(const State::Msg* msg){
+    	return (MsgBlock*)((uintptr_t)msg - offsetof(MsgBlock, msg));
+    }
+
+    /** Obtiene el pool del que se ha reservado el bloque de un mensaje gestionado
+     *  @param msg Mensaje
+     *  @return Pool o NULL si no es un mensaje gestionado
+     */
+    static MsgPool* blockOwner(const State::Msg* msg){
+    	if(!msg){
+    		return NULL;
+    	}
+    	const MsgBlock* blk = getMsgBlock(msg);
+    	MsgPool* pool = MsgPool::findBlock(blk, sizeof(MsgBlock));
+    	return (pool && blk->tag == (MsgBlockTag ^ (uint32_t)(uintptr_t)blk))? pool : NULL;
+    }
+
+    static MsgPool* _msg_blocks;				/// Pool compartido de bloques de mensajes gestionados
+
+    std::atomic<int32_t> _queue_count;
+    static std::atomic<int32_t> _max_queue_count;
 
     /** Tiempo de espera por defecto al postear un mensaje */
     static const uint32_t DefaultPutTimeout = MQ::MQBroker::DefaultMutexTimeout;
@@ -94,19 +647,103 @@ class ActiveModule : public StateMachine {
     bool _defdbg;								/// Flag para depuraci�n por defecto
     MQ::SubscribeCallback   _subscriptionCb;    /// Callback de suscripci�n a topics
     MQ::PublishCallback     _publicationCb;     /// Callback de publicaci�n en topics
+    MsgPool* _pool;								/// Gestor de bloques para mensajes (NULL: heap)
+    TopicMap* _topic_map;						/// Tabla de topics suscritos (NULL: sin registrar)
+    TimerWheel* _timers;						/// Rueda de temporizacion (NULL: sin temporizadores)
+    ParamCache* _param_cache;					/// Cache de parametros NV (NULL: acceso directo a _fs)
+    TraceRecorder* _trace;						/// Registro binario de mensajes (NULL: deshabilitado)
+    uint8_t* _cfg_shadow;						/// Copia de la configuracion grabada en memoria NV (ConfigSchema)
     FSManager* _fs;								/// Gestor del sistema de backup en memoria NVS
     bool _ready;								/// Flag para indicar el estado del m�dulo a nivel de thread
     bool _wdt_handled;							/// Flag para indicar si debe reportar al TaskWatchdog
     uint32_t _wdt_millis;						/// Cadencia en ms para notificar actividad al TaskWatchdog
     char* _wdt_topic;							/// Topic en el que publicar la notificaci�n de actividad
     char* _wdt_name;							/// Nombre del componente que publica la notificaci�n
+    uint16_t _wdt_name_len;						/// Tamano de _wdt_name incluyendo el terminador
+    int32_t _wdt_id;							/// Entrada en la tabla TaskHeartbeat
+    uint32_t _wdt_last;							/// Instante de la ultima notificacion de actividad
 
     /** M�ximo n�mero de mensajes alojables en la cola asociada a la m�quina de estados */
     static const uint32_t DefaultMaxQueueMessages = 48;
 
-    /** Cola de mensajes de la m�quina de estados */
+    /** Cola de mensajes de la m�quina de estados (carril LaneNormal del mailbox del RTOS) */
     Queue<State::Msg, DefaultMaxQueueMessages> _queue;
 
+    /** Capacidad de los carriles LaneUrgent y LaneBackground del mailbox del RTOS */
+    static const uint32_t LaneQueueMessages = 16;
+
+    /** Colas de los carriles LaneUrgent y LaneBackground del mailbox del RTOS */
+    Queue<State::Msg, LaneQueueMessages> _urgent_queue;
+    Queue<State::Msg, LaneQueueMessages> _background_queue;
+
+    /** Capacidad de cada carril del mailbox lock-free (debe ser potencia de 2) */
+    static const uint32_t LockFreeQueueMessages = 64;
+
+    /** Carril de prioridad del mailbox lock-free */
+    typedef MPSCQueue<State::Msg, LockFreeQueueMessages> LockFreeLane;
+
+    /** Contadores de un carril de prioridad */
+    struct Lane {
+    	std::atomic<uint32_t> depth;
+    	std::atomic<uint32_t> max_depth;
+    	std::atomic<uint32_t> puts;
+    	std::atomic<uint32_t> rejects;
+    	std::atomic<uint32_t> waiters;			/// Productores esperando hueco (PolicyBlock)
+    	Semaphore space;						/// Senalizacion de hueco liberado por el consumidor (PolicyBlock)
+    	uint32_t limit;							/// Limite de profundidad
+    };
+
+    /** Politica de sobrecarga asociada a una senal */
+    struct SignalPolicy {
+    	uint32_t sig;							/// Senal (0: politica del modulo)
+    	uint8_t policy;							/// OverloadPolicy
+    	uint32_t millis;						/// Espera maxima en PolicyBlock
+    	bool coalesce;							/// Senal fusionable
+    };
+
+    /** Maximo numero de senales con politica propia */
+    static const uint8_t MaxSignalPolicies = 8;
+
+    /** Maximo numero de mensajes pendientes sustituibles (PolicyReplace y senales fusionables) */
+    static const uint8_t MaxPendingReplace = 8;
+
+    SignalPolicy _policy;						/// Politica por defecto del modulo
+    SignalPolicy _sig_policies[MaxSignalPolicies];	/// Politicas por senal
+    State::Msg* _pending[MaxPendingReplace];	/// Mensajes encolados sustituibles
+    volatile uint8_t _pending_count;			/// Numero de mensajes en _pending
+    struct {
+    	std::atomic<uint32_t> rejected;
+    	std::atomic<uint32_t> timeouts;
+    	std::atomic<uint32_t> dropped;
+    	std::atomic<uint32_t> replaced;
+    	std::atomic<uint32_t> merged;
+    } _overload;								/// Contadores de sobrecarga
+    std::atomic<uint32_t> _msg_bytes;			/// Bytes de mensajes gestionados reservados
+    std::atomic<uint32_t> _msg_bytes_max;		/// Maximo de _msg_bytes
+
+    MailboxType _mbx_type;						/// Tipo de mailbox utilizado
+    LockFreeLane* _lf_lanes;					/// Carriles del mailbox lock-free (reservados en setMailboxType)
+    Semaphore _mbx_sem{0, MaxLanes * LockFreeQueueMessages};	/// Senalizacion de mensajes en el mailbox (un token por mensaje)
+    std::atomic<uint32_t> _mbx_credit;			/// Tokens obtenidos de _mbx_sem cuyo mensaje no se ha extraido todavia
+    Lane _lanes[MaxLanes];						/// Contadores por carril
+    uint32_t _starvation_limit;					/// Maximo de extracciones seguidas saltando carriles pendientes (0: sin limite)
+    uint32_t _starvation_count;					/// Extracciones seguidas saltando carriles pendientes
+    uint32_t _batch_size;						/// Maximo de mensajes procesados por despertar
+
+    /** Contadores de metricas. Los actualizados por los productores son atomicos, el resto solo los actualiza
+     *  el thread del modulo. */
+    struct {
+    	std::atomic<uint32_t> queue_max_depth;
+    	uint32_t dispatched;
+    	uint32_t wait_timeouts;
+    	uint32_t latency[LatencyBuckets];
+    	SignalMetrics signals[MaxSignalMetrics];
+    	uint16_t num_signals;
+    } _metrics;
+    uint32_t _metrics_period;					/// Periodo de publicacion de metricas (0: deshabilitada)
+    uint32_t _metrics_last;						/// Instante de la ultima publicacion de metricas
+    TopicHandle _metrics_topic;					/// Topic de publicacion de metricas
+
 
     State _stInit;								/// Variable de estado para stInit
 
@@ -117,11 +754,170 @@ class ActiveModule : public StateMachine {
     virtual osEvent getOsEvent();
 
 
+    /** Selecciona el tipo de mailbox. Debe invocarse desde el constructor de la clase heredera, antes de
+     *  asignar los topics base y de postear ningun mensaje.
+     *  @param type Tipo de mailbox
+     */
+    void setMailboxType(MailboxType type);
+
+
+    /** Establece el limite de profundidad de un carril. Al alcanzarlo, putMessage rechaza los mensajes del carril.
+     *  El limite se acota a la capacidad del carril en el mailbox seleccionado (laneCapacity) y setMailboxType lo
+     *  restablece a dicha capacidad.
+     *  @param lane Carril
+     *  @param limit Maximo de mensajes pendientes en el carril
+     */
+    void setLaneDepth(uint8_t lane, uint32_t limit){
+    	_lanes[lane].limit = (limit < laneCapacity(lane))? limit : laneCapacity(lane);
+    }
+
+
+    /** Obtiene la capacidad fisica de un carril en el mailbox seleccionado
+     *  @param lane Carril
+     *  @return Maximo de mensajes alojables en el carril
+     */
+    uint32_t laneCapacity(uint8_t lane) const {
+    	if(_mbx_type == LockFreeMailbox){
+    		return LockFreeQueueMessages;
+    	}
+    	return (lane == LaneNormal)? DefaultMaxQueueMessages : LaneQueueMessages;
+    }
+
+
+    /** Habilita la proteccion frente a inanicion: tras 'limit' extracciones seguidas
+     *  de un carril mas prioritario habiendo mensajes pendientes en carriles inferiores, se extrae uno de estos.
+     *  @param limit Numero de extracciones seguidas permitidas (0: deshabilitada)
+     */
+    void setStarvationLimit(uint32_t limit){
+    	_starvation_limit = limit;
+    }
+
+
+    /** Establece el numero maximo de mensajes procesados en cada despertar del thread. El primer mensaje se obtiene
+     *  con getOsEvent (incluida la notificacion al TaskWatchdog) y el resto, si ya estan pendientes, directamente del
+     *  mailbox sin esperar. Requiere utilizar el mailbox de ActiveModule (sin redefinir getOsEvent con otra cola).
+     *  @param batch_size Maximo de mensajes por lote (1: un mensaje por despertar, por defecto)
+     */
+    void setBatchSize(uint32_t batch_size){
+    	_batch_size = (batch_size)? batch_size : 1;
+    }
+
+
+    /** Notificacion de inicio de un lote de mensajes, antes de procesar el primero
+     */
+    virtual void batchStarted(){}
+
+
+    /** Notificacion de fin de un lote de mensajes. Permite agrupar operaciones costosas (grabacion NVS,
+     *  publicaciones) en una por lote en lugar de una por mensaje.
+     *  @param count Numero de mensajes procesados en el lote
+     */
+    virtual void batchCompleted(uint32_t /*count*/){}
+
+
+    /** Obtiene el identificador del estado actual, anotado en el registro binario tras cada despacho. Las clases
+     *  herederas pueden redefinirlo para identificar sus estados.
+     *  @return Identificador del estado (0 por defecto)
+     */
+    virtual uint8_t traceState(){
+    	return 0;
+    }
+
+
+    /** Obtiene el carril de un mensaje (LaneNormal si no es un mensaje gestionado)
+     *  @param msg Mensaje
+     *  @return Carril
+     */
+    static uint8_t getMsgLane(const State::Msg* msg){
+    	return (isManagedMessage(msg))? getMsgBlock(msg)->lane : (uint8_t)LaneNormal;
+    }
+
+
+    /** Reserva memoria para un mensaje o sus datos asociados, desde el gestor de bloques si esta asignado
+     *  @param size Tamano requerido
+     *  @return Puntero a la memoria reservada
+     */
+    void* memAlloc(size_t size){
+    	if(_pool){
+    		return _pool->alloc(size);
+    	}
+    	// el heap no es utilizable desde ISR
+    	return (IS_ISR())? NULL : Heap::memAlloc(size);
+    }
+
+
+    /** Libera memoria reservada con memAlloc
+     *  @param ptr Memoria a liberar
+     */
+    void memFree(void* ptr){
+    	if(_pool){
+    		_pool->free(ptr);
+    	}
+    	else if(ptr){
+    		Heap::memFree(ptr);
+    	}
+    }
+
+
+    /** Crea un topic de publicacion "<pub_topic_base>/<suffix>" una unica vez, para reutilizarlo en cada publish.
+     *  Debe invocarse una vez asignado el topic base de publicacion (ej. en Init::EV_ENTRY).
+     *  @param suffix Sufijo del topic (ej. "stat/cfg")
+     *  @return Topic preformateado
+     */
+    TopicHandle createPubTopic(const char* suffix);
+
+
+    /** Publica un RefBuffer en un topic preformateado sin copiar los datos. Los suscriptores pueden retenerlo
+     *  (newMessageRef o RefBuffer::retain). La referencia del publicador se libera al finalizar.
+     *  @param topic Topic preformateado
+     *  @param data Datos obtenidos con RefBuffer::create
+     *  @return Resultado de MQ::MQClient::publish
+     */
+    int32_t publish(const TopicHandle& topic, void* data);
+
+
     /** Rutina de entrada a la m�quina de estados (gestionada por la clase heredera)
      */
     virtual State::StateResult Init_EventHandler(State::StateEvent* se) = 0;
 
 
+    /** Maximo numero de topics registrables por defecto (ver reserveTopics) */
+    static const uint16_t DefaultMaxTopics = 32;
+
+
+    /** Reserva la tabla de topics suscritos para un numero de tokens. Debe invocarse antes de registerTopic si
+     *  se necesitan mas de DefaultMaxTopics.
+     *  @param max_topics Maximo numero de tokens
+     */
+    void reserveTopics(uint16_t max_topics);
+
+
+    /** Registra un token de suscripcion relativo a _sub_topic_base y su manejador. Un topic recibido se asocia al
+     *  token literal que coincide con su parte relativa (tabla hash) o, si no lo hay, al primer token con comodines
+     *  que cumpla MQClient::isTopicToken (ver TopicMap)
+     *  @param token Token (ej. "/which/event"), debe ser persistente. Admite comodines '+' y '#'.
+     *  @param handler Manejador invocado por dispatchTopic
+     *  @return Identificador del topic (>= 0) o -1 en caso de error
+     */
+    int32_t registerTopic(const char* token, MQ::SubscribeCallback handler);
+
+
+    /** Obtiene el identificador de un topic recibido
+     *  @param topic Topic recibido
+     *  @return Identificador o -1 si no esta registrado
+     */
+    int32_t getTopicId(const char* topic);
+
+
+    /** Despacha un topic recibido a su manejador registrado. Pensado para invocarse desde subscriptionCb.
+     *  @param topic Topic recibido
+     *  @param msg Mensaje recibido
+     *  @param msg_len Tamano del mensaje
+     *  @return True si se ha despachado, False si no hay manejador para el topic
+     */
+    bool dispatchTopic(const char* topic, void* msg, uint16_t msg_len);
+
+
 	/** Callback invocada al recibir una actualizaci�n de un topic local al que est� suscrito
      *  @param topic Identificador del topic
      *  @param msg Mensaje recibido
@@ -182,18 +978,385 @@ class ActiveModule : public StateMachine {
    * @return True: exito, False: no se pudo recuperar
   */
   virtual bool removeParameter(const char* param_id);
+
+
+	/** Asocia una cache de parametros con escritura diferida (propia o compartida entre modulos). A partir de
+	 *  entonces saveParameter, restoreParameter y removeParameter operan sobre la cache, que se vuelca en memoria
+	 *  NV al vencer su plazo (comprobado desde el thread del modulo) o al invocar flushParameters.
+	 * 	@param cache Cache de parametros
+	 */
+	void attachParamCache(ParamCache* cache){
+		_param_cache = cache;
+	}
+
+
+	/** Vuelca en memoria NV los cambios pendientes en la cache de parametros
+	 * 	@return True: exito (o sin cache), False: algun cambio no se pudo volcar
+	 */
+	bool flushParameters(){
+		return (_param_cache)? _param_cache->flush() : true;
+	}
+
+
+	/** Recupera una configuracion descrita por un esquema. Cada campo se recupera de su propia clave NV (nombre
+	 *  del modulo seguido de la clave del campo) y se
+	 *  verifica el CRC de la cabecera. Si la version grabada es anterior, los campos nuevos toman su valor por
+	 *  defecto y se graban junto con la nueva cabecera. Los campos fuera de rango se reparan con su valor por
+	 *  defecto. Si no hay configuracion grabada o esta corrupta, se establece la configuracion por defecto.
+	 * 	@param schema Esquema de la configuracion
+	 * 	@param cfg Receptor de la configuracion
+	 * 	@return True: recuperada de memoria NV, False: establecida por defecto
+	 */
+	bool schemaRestore(const ConfigSchema& schema, void* cfg);
+
+
+	/** Graba en memoria NV unicamente los campos modificados desde la ultima grabacion o recuperacion, y la
+	 *  cabecera con la version y el CRC si hay algun cambio
+	 * 	@param schema Esquema de la configuracion
+	 * 	@param cfg Configuracion
+	 * 	@return True: exito, False: algun campo no se pudo grabar
+	 */
+	bool schemaSave(const ConfigSchema& schema, const void* cfg);
+
+
+	/** Establece la configuracion por defecto y la graba completa en memoria NV
+	 * 	@param schema Esquema de la configuracion
+	 * 	@param cfg Receptor de la configuracion
+	 */
+	void schemaSetDefaults(const ConfigSchema& schema, void* cfg);
+
+
+	/** Chequea el rango de todos los campos, reparando con su valor por defecto los incorrectos y grabandolos
+	 * 	@param schema Esquema de la configuracion
+	 * 	@param cfg Configuracion
+	 * 	@return True si la integridad es correcta, False si se ha reparado algun campo
+	 */
+	bool schemaCheckIntegrity(const ConfigSchema& schema, void* cfg);
+
+
+    /** Maximo numero de temporizadores armados simultaneamente por defecto (ver reserveTimers) */
+    static const uint16_t DefaultMaxTimers = 8;
+
+
+    /** Reserva la rueda de temporizacion del modulo para un numero de temporizadores. Debe invocarse antes de
+     *  startTimer si se necesitan mas de DefaultMaxTimers.
+     *  @param max_timers Maximo numero de temporizadores armados simultaneamente
+     */
+    void reserveTimers(uint16_t max_timers);
+
+
+    /** Arma un temporizador que, al vencer, postea en la cola del modulo un mensaje gestionado sin datos con la
+     *  senal indicada. El armado y la cancelacion son O(1) y no requieren threads adicionales. No invocar desde ISR.
+     *  @param sig Senal a postear
+     *  @param delay Milisegundos hasta el primer vencimiento (resolucion TIMERSERVICE_TICK_MS)
+     *  @param period Periodo en milisegundos (0: de un solo disparo)
+     *  @return Identificador del temporizador o -1 si no quedan temporizadores libres
+     */
+    int32_t startTimer(uint32_t sig, uint32_t delay, uint32_t period = 0);
+
+
+    /** Cancela un temporizador. Si ya habia vencido, su mensaje puede estar pendiente en la cola.
+     *  @param id Identificador obtenido en startTimer
+     *  @return True: cancelado, False: ya vencido, cancelado o identificador invalido
+     */
+    bool cancelTimer(int32_t id);
+
+
+    /** Realiza una llamada asincrona a otro modulo. La peticion se postea directamente en la cola del destino,
+     *  que la atiende con la senal sig y responde con reply(). La respuesta (o su vencimiento, ver isCallTimeout)
+     *  se recibe en la cola de este modulo con la senal reply_sig y el identificador de correlacion devuelto
+     *  (getMsgCorrId). Ningun thread queda bloqueado. No invocar desde ISR.
+     *  @param target Modulo destino
+     *  @param sig Senal de la peticion en el destino
+     *  @param data Datos de la peticion (se copian)
+     *  @param size Tamano de los datos
+     *  @param reply_sig Senal de la respuesta en este modulo
+     *  @param timeout Milisegundos hasta el vencimiento (0: sin vencimiento)
+     *  @return Identificador de correlacion o 0 si no se pudo realizar la llamada (sin entradas o temporizadores
+     *  libres, o sin espacio en la cola del destino)
+     */
+    uint32_t call(ActiveModule* target, uint32_t sig, const void* data, uint16_t size, uint32_t reply_sig, uint32_t timeout = 0);
+
+
+    /** Responde a una peticion recibida mediante call. Si la llamada ya vencio o fue cancelada, la respuesta
+     *  se descarta. No invocar desde ISR.
+     *  @param req Mensaje de la peticion
+     *  @param data Datos de la respuesta (se copian)
+     *  @param size Tamano de los datos
+     *  @return True: respuesta entregada, False: el mensaje no es una peticion o la llamada ya no esta pendiente
+     */
+    bool reply(const State::Msg* req, const void* data, uint16_t size);
+
+
+    /** Cancela una llamada pendiente. Su respuesta posterior se descartara.
+     *  @param corr Identificador de correlacion
+     *  @return True: cancelada, False: no estaba pendiente
+     */
+    bool cancelCall(uint32_t corr);
   
   private:
 
+    friend class ActiveExecutor;
+
+	/** Graba los campos indicados de una configuracion y su cabecera, actualizando la copia grabada
+	 * 	@param schema Esquema de la configuracion
+	 * 	@param cfg Configuracion
+	 * 	@param mask Campos a grabar (bit i: campo i)
+	 * 	@return True: exito, False: algun campo no se pudo grabar
+	 */
+	bool schemaWrite(const ConfigSchema& schema, const void* cfg, uint32_t mask);
+
+
+	/** Forma la clave NV de una clave del esquema, con el nombre del modulo como prefijo (ConfigSchema::nvKey)
+	 * 	@param key Clave local del esquema o de un campo
+	 * 	@param buf Receptor de la clave NV (ConfigSchema::MaxKeyLength+1 bytes)
+	 */
+	void schemaKey(const char* key, char* buf);
+
+
+	/** Postea un mensaje aplicando la politica de sobrecarga de su senal
+	 * 	@param msg Mensaje a postear (se toma su propiedad)
+	 * 	@param can_block False: no espera aunque la politica sea PolicyBlock
+	 * 	@return Resultado
+	 */
+	osStatus postMessage(State::Msg* msg, bool can_block);
+
+
+	/** Callback de vencimiento de temporizadores, invocada desde el thread de TimerService
+	 * 	@param sig Senal a postear
+	 */
+	void timerExpired(uint32_t sig);
+
+
+	/** Contabiliza la memoria reservada (bytes > 0) o liberada (bytes < 0) para mensajes gestionados
+	 * 	@param bytes Bytes reservados o liberados
+	 */
+	void msgAccount(int32_t bytes){
+		uint32_t cur = _msg_bytes.fetch_add((uint32_t)bytes) + (uint32_t)bytes;
+		uint32_t max = _msg_bytes_max;
+		while(bytes > 0 && cur > max && !_msg_bytes_max.compare_exchange_weak(max, cur));
+	}
+
+
+	/** Entrega en la cola del modulo la respuesta de una llamada pendiente, o su vencimiento si data es NULL. La
+	 *  llamada solo se libera si el mensaje se encola; en otro caso sigue pendiente y su vencimiento se mantiene
+	 *  (o se reintenta en CallRetryMillis si ya ha vencido).
+	 * 	@param corr Identificador de correlacion
+	 * 	@param data Datos de la respuesta
+	 * 	@param size Tamano de los datos
+	 * 	@param timeout True: vencimiento de la llamada
+	 * 	@return True: entregada, False: la llamada no esta pendiente o no se pudo encolar el mensaje
+	 */
+	bool deliverReply(uint32_t corr, const void* data, uint16_t size, bool timeout);
+
+
+	/** Reserva una llamada pendiente para liberarla (closing), de forma que un vencimiento concurrente no la
+	 *  entregue. Si el vencimiento llega con la entrada reservada, se anota (expired) para reintentarlo.
+	 * 	@param corr Identificador de correlacion
+	 * 	@param timeout True: reservada por el vencimiento de su temporizador
+	 * 	@param reply_sig Recibe la senal de la respuesta
+	 * 	@param slot Recibe la entrada en _calls
+	 * 	@return True: reservada, False: no estaba pendiente o ya estaba reservada
+	 */
+	bool callClaim(uint32_t corr, bool timeout, uint32_t& reply_sig, uint8_t& slot);
+
+
+	/** Libera una llamada reservada con callClaim. Si tiene temporizador y no ha vencido, lo cancela antes de
+	 *  liberar la entrada, de forma que un vencimiento en curso no la confunda con una nueva llamada que la reutilice.
+	 * 	@param slot Entrada en _calls
+	 * 	@param timeout True: liberada por el vencimiento de su temporizador
+	 */
+	void callRelease(uint8_t slot, bool timeout);
+
+
+	/** Devuelve a pendiente una llamada reservada con callClaim cuya respuesta o vencimiento no se pudo entregar.
+	 *  Si su temporizador ya ha vencido, lo rearma con CallRetryMillis.
+	 * 	@param slot Entrada en _calls
+	 * 	@param timeout True: reservada por el vencimiento de su temporizador
+	 */
+	void callRestore(uint8_t slot, bool timeout);
+
+    /** Llamada asincrona pendiente de respuesta */
+    struct PendingCall {
+    	uint32_t corr;							/// Identificador de correlacion (0: libre)
+    	uint32_t reply_sig;						/// Senal de la respuesta
+    	int32_t timer_id;						/// Temporizador de vencimiento (-1: sin vencimiento)
+    	bool closing;							/// Reservada para liberarla (ver callClaim)
+    	bool expired;							/// Temporizador vencido mientras estaba reservada
+    };
+
+    /** Senales de temporizador reservadas para el vencimiento de llamadas (bits bajos: entrada en _calls) */
+    static const uint32_t CallTimeoutSig = 0xCA110000;
+    static const uint32_t CallTimeoutMask = 0xFFFF0000;
+
+    /** Reintento de la entrega de un vencimiento que no se pudo encolar (sin memoria o cola llena) */
+    static const uint32_t CallRetryMillis = 10;
+
+    PendingCall _calls[ACTIVEMODULE_MAX_CALLS];	/// Llamadas pendientes de respuesta
+    uint32_t _call_seq;							/// Ultimo identificador de correlacion asignado
+
     static const uint8_t MaxNameLength = 16;	/// Tama�o del nombre
-    Thread* _th;								/// Thread asociado al m�dulo
+    Thread* _th;								/// Thread asociado al m�dulo (NULL en modo executor)
+    ActiveExecutor* _executor;					/// Executor asociado (NULL en modo thread propio)
+    osPriority _priority;						/// Prioridad del modulo
+    std::atomic<bool> _scheduled;				/// Modulo encolado o en ejecucion en el executor
+    std::atomic<bool> _started;					/// Maquina de estados iniciada (Init EV_ENTRY completado)
     char _name[MaxNameLength+1];				/// Nombre del m�dulo (ej. "[Name]..........")
-    Semaphore _sem_th{0,1};
+    Semaphore _sem_th{0,1};						/// Notificacion de eventos de arranque (modo thread propio)
+    bool _start_forced;							/// Arranque sin topics base (start)
+    uint32_t _startup_ms;						/// Instante de construccion y, tras el arranque, tiempo de arranque
+    ActiveModule* _deps[MaxDependencies];		/// Modulos de los que depende el arranque
+    ActiveModule* _dependents[MaxDependencies];	/// Modulos a notificar al completar el arranque
+    Callback<osStatus(State::Msg*)> _msg_handler;	/// Manejador de mensajes de la maquina de estados
+
+    /** Inicializa las propiedades comunes a ambos modos de ejecucion
+     */
+    void init(const char* name, osPriority priority, FSManager* fs, bool defdbg);
+
 
     /** Hilo de ejecuci�n propio.
      */
     void task();
 
+
+    /** Notifica un evento de arranque (topics base, start o dependencia completada). El thread del modulo (o su
+     *  executor) arranca desde el constructor base y ejecuta el estado inicial en cuanto se cumplen las condiciones
+     *  de arranque, por lo que los eventos que las completan no pueden producirse durante la construccion de la
+     *  clase heredera.
+     */
+    void startupNotify(){
+    	if(_executor){
+    		scheduleRun();
+    	}
+    	else{
+    		_sem_th.release();
+    	}
+    }
+
+
+    /** Chequea si se cumplen las condiciones de arranque: topics base asignados (o start) y dependencias iniciadas
+     *  @return True: puede ejecutar el estado inicial
+     */
+    bool startupReady();
+
+
+    /** Registra el fin del arranque y notifica a los modulos dependientes
+     */
+    void startupCompleted();
+
+
+    /** Encola el modulo en su executor si no lo estaba ya
+     */
+    void scheduleRun(){
+    	if(!_scheduled.exchange(true)){
+    		_executor->schedule(this);
+    	}
+    }
+
+
+    /** Procesa un lote de mensajes pendientes desde un thread del executor
+     */
+    void executorRun();
+
+
+    /** Notifica actividad al TaskWatchdog si ha transcurrido al menos medio periodo desde la anterior
+     */
+    void heartbeat();
+
+
+    /** Publica las metricas si ha transcurrido su periodo de publicacion
+     */
+    void publishMetrics();
+
+
+    /** Obtiene la espera maxima del thread para atender las tareas periodicas (watchdog, metricas, volcado NV)
+     *  @return Milisegundos
+     */
+    uint32_t periodicWait();
+
+
+    /** Ejecuta las tareas periodicas que hayan vencido
+     */
+    void periodicTasks();
+
+
+    /** Chequea si el modulo tiene alguna tarea periodica habilitada (tick de ActiveExecutor)
+     *  @return True: TaskWatchdog, metricas o ParamCache
+     */
+    bool hasPeriodicTasks() const {
+    	return _wdt_handled || _metrics_period || _param_cache;
+    }
+
+
+    /** Procesa un mensaje en la maquina de estados y lo libera si es gestionado
+     *  @param oe Evento con el mensaje
+     */
+    void dispatch(osEvent* oe);
+
+
+    /** Inserta un mensaje en el mailbox seleccionado
+     *  @param msg Mensaje
+     *  @param lane Carril de prioridad
+     *  @param millis Tiempo maximo de espera a que el consumidor libere hueco en el carril
+     *  @param evict Con el carril lleno descarta su mensaje mas antiguo en lugar de esperar (PolicyDropOldest)
+     *  @return Resultado
+     */
+    osStatus mailboxPut(State::Msg* msg, uint8_t lane, uint32_t millis, bool evict = false);
+
+
+    /** Obtiene la politica de sobrecarga aplicable a una senal
+     *  @param sig Senal
+     *  @return Politica
+     */
+    const SignalPolicy& getSignalPolicy(uint32_t sig);
+
+
+    /** Libera un mensaje descartado, gestionado o no (en ese caso se liberan msg->msg y msg con memFree)
+     *  @param msg Mensaje
+     */
+    void disposeMessage(State::Msg* msg);
+
+
+    /** Registra un mensaje sustituible antes de encolarlo
+     *  @param msg Mensaje
+     *  @return True si se ha registrado
+     */
+    bool pendingAdd(State::Msg* msg);
+
+
+    /** Elimina un mensaje de la tabla de sustituibles (al extraerlo o si no se ha podido encolar)
+     *  @param msg Mensaje
+     */
+    void pendingRemove(State::Msg* msg);
+
+
+    /** Sustituye los datos de un mensaje pendiente con la misma senal por los de un nuevo mensaje, que se libera
+     *  @param msg Nuevo mensaje
+     *  @return True si se ha sustituido
+     */
+    bool pendingReplace(State::Msg* msg);
+
+
+    /** Extrae un mensaje del mailbox seleccionado
+     *  @param millis Tiempo maximo de espera
+     *  @return Evento con el mensaje o con estado osEventTimeout
+     */
+    osEvent mailboxGet(uint32_t millis);
+
+
+    /** Extrae el mensaje mas prioritario del mailbox, aplicando la proteccion frente a inanicion
+     *  @param lane Recibe el carril del que se ha extraido el mensaje
+     *  @return Mensaje o NULL si no hay ninguno publicado
+     */
+    State::Msg* laneGet(uint8_t& lane);
+
+
+    /** Extrae el mensaje mas antiguo de un carril, sin esperar
+     *  @param lane Carril
+     *  @return Mensaje o NULL si el carril no tiene ninguno publicado
+     */
+    State::Msg* laneTake(uint8_t lane);
+
 };
      
 #endif /*__ActiveModule__H */
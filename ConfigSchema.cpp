@@ -0,0 +1,72 @@
+/*
+ * ConfigSchema.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "ConfigSchema.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+uint32_t ConfigSchema::crc(const void* cfg, uint16_t version) const {
+	uint32_t crc = 0xFFFFFFFF;
+	for(uint8_t i = 0; i < num_fields; i++){
+		if(fields[i].since > version){
+			continue;
+		}
+		const uint8_t* p = (const uint8_t*)cfg + fields[i].offset;
+		for(uint16_t n = 0; n < fields[i].size; n++){
+			crc ^= p[n];
+			for(uint8_t b = 0; b < 8; b++){
+				crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+			}
+		}
+	}
+	return ~crc;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ConfigSchema::inRange(const ConfigField& f, const void* cfg){
+	if(f.min > f.max || !f.elem_size){
+		return true;
+	}
+	const uint8_t* p = (const uint8_t*)cfg + f.offset;
+	for(uint16_t n = 0; n + f.elem_size <= f.size; n += f.elem_size){
+		int32_t v;
+		switch(f.elem_size){
+			case 1:	v = p[n]; break;
+			case 2:	{ uint16_t u; memcpy(&u, &p[n], 2); v = u; break; }
+			case 4:	memcpy(&v, &p[n], 4); break;
+			default: return true;
+		}
+		if(v < f.min || v > f.max){
+			return false;
+		}
+	}
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void ConfigSchema::nvKey(const char* module, size_t module_len, const char* key, char* buf){
+	size_t key_len = strlen(key);
+	MBED_ASSERT(key_len <= MaxFieldKeyLength);
+	size_t room = MaxKeyLength - key_len;
+	if(module_len <= room){
+		sprintf(buf, "%.*s%s", (int)module_len, module, key);
+		return;
+	}
+	// nombre truncado: se distingue de otros con el mismo prefijo mediante el hash FNV-1a del nombre completo
+	uint32_t h = 2166136261UL;
+	for(size_t i = 0; i < module_len; i++){
+		h = (h ^ (uint8_t)module[i]) * 16777619UL;
+	}
+	sprintf(buf, "%.*s%04X%s", (int)(room - 4), module, (unsigned)((h ^ (h >> 16)) & 0xFFFF), key);
+}
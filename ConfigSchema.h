@@ -0,0 +1,121 @@
+/*
+ * ConfigSchema.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	ConfigSchema describe en tiempo de compilacion los campos de la estructura de configuracion de un modulo: clave
+ *	NV, posicion, tamano, rango valido y version en la que aparece cada campo, junto con la configuracion por defecto.
+ *	ActiveModule utiliza esta descripcion (schemaRestore, schemaSave, ...) para:
+ *	  - Persistir cada campo en su propia clave NV, grabando unicamente los campos modificados.
+ *	  - Guardar una cabecera con la version y el CRC32 de los campos para verificar la integridad.
+ *	  - Migrar configuraciones de versiones anteriores, asignando su valor por defecto a los campos nuevos.
+ *
+ *	Las claves del esquema y de los campos son locales al modulo (MaxFieldKeyLength caracteres como maximo). La
+ *	clave NV se forma anteponiendo el nombre del modulo (ver nvKey), de forma que modulos distintos con claves
+ *	iguales no colisionen.
+ *
+ *	Ejemplo:
+ *		static const Config DefaultCfg = {{0,0,0}, 50};
+ *		static const ConfigField CfgFields[] = {
+ *			CONFIG_ARRAY(Config, color, "Color", 0, 255, 1),
+ *			CONFIG_FIELD(Config, speed, "Speed", 0, 100, 1),
+ *		};
+ *		static const ConfigSchema CfgSchema = CONFIG_SCHEMA(Config, "Cfg", 1, CfgFields, DefaultCfg);
+ *		// claves NV del modulo "Led": "LedCfg", "LedColor", "LedSpeed"
+ */
+
+#ifndef __ConfigSchema__H
+#define __ConfigSchema__H
+
+#include "mbed.h"
+
+
+/** Descripcion de un campo de la configuracion */
+struct ConfigField {
+	const char* key;							/// Clave del campo (local al modulo)
+	uint16_t offset;							/// Posicion del campo en la estructura
+	uint16_t size;								/// Tamano del campo
+	uint8_t elem_size;							/// Tamano de cada elemento (campos array) para el chequeo de rango
+	int32_t min;								/// Valor minimo de cada elemento
+	int32_t max;								/// Valor maximo de cada elemento (min > max: sin chequeo de rango)
+	uint16_t since;								/// Version de la configuracion en la que aparece el campo
+};
+
+
+/** Descripcion de la configuracion completa */
+struct ConfigSchema {
+	const char* key;							/// Clave de la cabecera (version y CRC, local al modulo)
+	uint16_t version;							/// Version actual de la configuracion
+	const ConfigField* fields;					/// Campos
+	uint8_t num_fields;							/// Numero de campos
+	uint16_t size;								/// Tamano de la estructura de configuracion
+	const void* defaults;						/// Configuracion por defecto
+
+
+	/** Numero maximo de campos de una configuracion */
+	static const uint8_t MaxFields = 32;
+
+
+	/** Longitud maxima de una clave NV (limite de NVS) */
+	static const uint8_t MaxKeyLength = 15;
+
+
+	/** Longitud maxima de la clave local de un campo o de la cabecera */
+	static const uint8_t MaxFieldKeyLength = 8;
+
+
+	/** Calcula el CRC32 de los campos presentes en una version (sin incluir el relleno de la estructura)
+	 *  @param cfg Configuracion
+	 *  @param version Version de la configuracion
+	 *  @return CRC32
+	 */
+	uint32_t crc(const void* cfg, uint16_t version) const;
+
+
+	/** Chequea si un campo esta dentro de su rango
+	 *  @param f Campo
+	 *  @param cfg Configuracion
+	 *  @return True si es valido
+	 */
+	static bool inRange(const ConfigField& f, const void* cfg);
+
+
+	/** Forma la clave NV de una clave local anteponiendo el nombre del modulo. Si el nombre no cabe en
+	 *  MaxKeyLength junto con la clave, se trunca y se completa con 4 digitos hex del hash de su nombre completo.
+	 *  @param module Nombre del modulo
+	 *  @param module_len Longitud del nombre del modulo
+	 *  @param key Clave local (MaxFieldKeyLength caracteres como maximo)
+	 *  @param buf Receptor de la clave NV (MaxKeyLength+1 bytes)
+	 */
+	static void nvKey(const char* module, size_t module_len, const char* key, char* buf);
+};
+
+
+/** Cabecera persistida de una configuracion */
+struct ConfigHeader {
+	uint16_t version;							/// Version de la configuracion grabada
+	uint16_t num_fields;						/// Numero de campos grabados
+	uint32_t crc;								/// CRC32 de los campos
+};
+
+
+/** Declara un campo escalar de la configuracion */
+#define CONFIG_FIELD(type, member, key, min, max, since) \
+	{ key, (uint16_t)offsetof(type, member), (uint16_t)sizeof(((type*)0)->member), (uint8_t)sizeof(((type*)0)->member), min, max, since }
+
+/** Declara un campo array de la configuracion, con chequeo de rango por elemento */
+#define CONFIG_ARRAY(type, member, key, min, max, since) \
+	{ key, (uint16_t)offsetof(type, member), (uint16_t)sizeof(((type*)0)->member), (uint8_t)sizeof(((type*)0)->member[0]), min, max, since }
+
+/** Declara un campo sin chequeo de rango (cadenas, estructuras) */
+#define CONFIG_BLOB(type, member, key, since) \
+	{ key, (uint16_t)offsetof(type, member), (uint16_t)sizeof(((type*)0)->member), 0, 1, 0, since }
+
+/** Declara el esquema de una configuracion */
+#define CONFIG_SCHEMA(type, key, version, fields, defaults) \
+	{ key, version, fields, (uint8_t)(sizeof(fields)/sizeof(fields[0])), (uint16_t)sizeof(type), &defaults }
+
+#endif /*__ConfigSchema__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,125 @@
+/*
+ * DeferredLog.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "DeferredLog.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+DeferredLog::Entry DeferredLog::_entries[DEFERREDLOG_SIZE];
+std::atomic<uint32_t> DeferredLog::_wr(0);
+uint32_t DeferredLog::_rd = 0;
+std::atomic<uint32_t> DeferredLog::_dropped(0);
+std::atomic<bool> DeferredLog::_started(false);
+Mutex DeferredLog::_drain_mtx;
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+uint32_t DeferredLog::drain(){
+	_drain_mtx.lock();
+	uint32_t count = 0;
+	for(;;){
+		uint32_t idx = _rd & (DEFERREDLOG_SIZE - 1);
+		Entry& e = _entries[idx];
+		if(e.seq.load(std::memory_order_acquire) != _rd - idx + 1){
+			break;
+		}
+		uintptr_t a[MaxArgs] = {0};
+		for(uint8_t i = 0; i < e.nargs; i++){
+			a[i] = (e.text_mask & (1 << i))? (uintptr_t)&e.text[e.args[i]] : e.args[i];
+		}
+		printf("\r\n%u [%c] %s ", (unsigned)e.ts, (char)e.level, (e.module)? e.module : "");
+		printf(e.fmt, a[0], a[1], a[2], a[3]);
+		// libera la posicion para la siguiente vuelta del buffer
+		e.seq.store(_rd - idx + DEFERREDLOG_SIZE, std::memory_order_release);
+		_rd++;
+		count++;
+	}
+	uint32_t dropped = _dropped.exchange(0, std::memory_order_relaxed);
+	if(dropped){
+		printf("\r\n[W] DeferredLog %d trazas descartadas", (int)dropped);
+	}
+	_drain_mtx.unlock();
+	return count;
+}
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE METHODS IMPLEMENTATION --------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+void DeferredLog::post(Level level, const char* module, const char* fmt, const uintptr_t* args, uint8_t nargs, uint8_t text_mask){
+	if(!_started.load(std::memory_order_relaxed) && !IS_ISR() && !_started.exchange(true)){
+		Thread* th = new Thread(osPriorityLow, OS_STACK_SIZE, NULL, "DeferredLog");
+		MBED_ASSERT(th);
+		th->start(callback(&DeferredLog::task));
+	}
+	// reserva una posicion (cola acotada de multiples productores). La secuencia de cada posicion se guarda
+	// relativa a su indice, de forma que el valor inicial 0 indica posicion libre sin necesidad de inicializarla.
+	uint32_t pos = _wr.load(std::memory_order_relaxed);
+	uint32_t idx;
+	Entry* e;
+	for(;;){
+		idx = pos & (DEFERREDLOG_SIZE - 1);
+		e = &_entries[idx];
+		int32_t dif = (int32_t)(e->seq.load(std::memory_order_acquire) - (pos - idx));
+		if(dif == 0){
+			if(_wr.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+				break;
+			}
+		}
+		else if(dif < 0){
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else{
+			pos = _wr.load(std::memory_order_relaxed);
+		}
+	}
+	e->module = module;
+	e->fmt = fmt;
+	e->ts = (uint32_t)Kernel::get_ms_count();
+	e->level = level;
+	e->nargs = nargs;
+	e->text_mask = text_mask;
+	// las cadenas transitorias se copian consecutivas en text, truncando cuando no caben
+	uint16_t used = 0;
+	for(uint8_t i = 0; i < nargs; i++){
+		if((text_mask & (1 << i)) == 0){
+			e->args[i] = args[i];
+			continue;
+		}
+		const char* str = (args[i])? (const char*)args[i] : "(null)";
+		uint16_t pos = (used < DEFERREDLOG_TEXT)? used : DEFERREDLOG_TEXT - 1;
+		uint16_t len = 0;
+		while(pos + len < DEFERREDLOG_TEXT - 1 && str[len]){
+			e->text[pos + len] = str[len];
+			len++;
+		}
+		e->text[pos + len] = 0;
+		e->args[i] = pos;
+		used = pos + len + 1;
+	}
+	e->seq.store(pos - idx + 1, std::memory_order_release);
+}
+
+
+//------------------------------------------------------------------------------------
+void DeferredLog::task(){
+	for(;;){
+		Thread::wait(DEFERREDLOG_DRAIN_MS);
+		drain();
+	}
+}
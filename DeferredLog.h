@@ -0,0 +1,166 @@
+/*
+ * DeferredLog.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	DeferredLog es un backend de trazas diferidas: el thread que genera la traza solo copia en un buffer circular
+ *	libre de bloqueos el puntero al formato, el modulo y hasta MaxArgs argumentos en crudo, con coste acotado y
+ *	sin bloquear (ISR-safe). Un thread de baja prioridad, creado en la primera traza, formatea y escribe las
+ *	trazas pendientes. Si el buffer esta lleno la traza se descarta y se contabiliza en dropped().
+ *
+ *	Restricciones: el formato y los argumentos '%s' deben ser cadenas persistentes (literales, nombres de modulo,
+ *	topics registrados...) ya que se formatean mas tarde; no se admiten argumentos en coma flotante. Las cadenas
+ *	transitorias (p.ej. el topic recibido en subscriptionCb) se pasan con DeferredLog::copy(str) o DEFERRED_STR(str),
+ *	que copian su contenido en la traza (DEFERREDLOG_TEXT bytes por traza, truncando si no caben).
+ *
+ *	Con ACTIVEMODULE_DEFERRED_LOG=0 las macros DEFERRED_TRACE_x equivalen a DEBUG_TRACE_x.
+ */
+
+#ifndef __DeferredLog__H
+#define __DeferredLog__H
+
+#include "mbed.h"
+#include <atomic>
+
+/** Habilita el backend de trazas diferidas */
+#ifndef ACTIVEMODULE_DEFERRED_LOG
+#define ACTIVEMODULE_DEFERRED_LOG	1
+#endif
+
+/** Numero de trazas del buffer circular (potencia de 2) */
+#ifndef DEFERREDLOG_SIZE
+#define DEFERREDLOG_SIZE			64
+#endif
+
+/** Bytes por traza para copiar las cadenas transitorias (DeferredLog::copy) */
+#ifndef DEFERREDLOG_TEXT
+#define DEFERREDLOG_TEXT			32
+#endif
+
+/** Periodo de volcado del thread de baja prioridad */
+#ifndef DEFERREDLOG_DRAIN_MS
+#define DEFERREDLOG_DRAIN_MS		50
+#endif
+
+
+class DeferredLog {
+  public:
+
+	/** Niveles de traza */
+	enum Level{
+		LevelError = 'E',
+		LevelWarning = 'W',
+		LevelInfo = 'I',
+		LevelDebug = 'D',
+		LevelVerbose = 'V',
+	};
+
+	/** Maximo numero de argumentos por traza */
+	static const uint8_t MaxArgs = 4;
+
+	static_assert(DEFERREDLOG_SIZE >= 2 && (DEFERREDLOG_SIZE & (DEFERREDLOG_SIZE - 1)) == 0, "DEFERREDLOG_SIZE debe ser potencia de 2");
+
+
+	/** Argumento '%s' transitorio, cuyo contenido se copia en la traza (ver copy) */
+	struct Text {
+		const char* str;
+	};
+
+
+    /** Marca una cadena transitoria para que se copie en la traza al encolarla
+     *  @param str Cadena
+     *  @return Argumento de log
+     */
+	static Text copy(const char* str){
+		Text t = { str };
+		return t;
+	}
+
+
+    /** Encola una traza. ISR-safe, no bloqueante. En la primera traza fuera de ISR se crea el thread de volcado.
+     *  @param level Nivel de la traza
+     *  @param module Nombre del modulo (persistente, NULL: sin prefijo)
+     *  @param fmt Formato printf (persistente)
+     *  @param args Argumentos enteros o punteros
+     */
+	template<typename... A>
+	static void log(Level level, const char* module, const char* fmt, A... args){
+		static_assert(sizeof...(A) <= MaxArgs, "DeferredLog: demasiados argumentos");
+		uintptr_t a[] = { 0, arg(args)... };
+		bool text[] = { false, isText(args)... };
+		uint8_t mask = 0;
+		for(uint8_t i = 0; i < sizeof...(A); i++){
+			mask |= (text[i + 1])? (1 << i) : 0;
+		}
+		post(level, module, fmt, &a[1], sizeof...(A), mask);
+	}
+
+
+    /** Formatea y escribe las trazas pendientes. Invocado por el thread de volcado; puede invocarse directamente
+     *  (p.ej. antes de un reset).
+     *  @return Numero de trazas escritas
+     */
+	static uint32_t drain();
+
+
+    /** Obtiene el numero de trazas descartadas por buffer lleno
+     *  @return Trazas descartadas
+     */
+	static uint32_t dropped(){
+		return _dropped.load(std::memory_order_relaxed);
+	}
+
+  private:
+
+	struct Entry {
+		std::atomic<uint32_t> seq;				/// Numero de secuencia de la posicion
+		const char* module;						/// Modulo
+		const char* fmt;						/// Formato
+		uint32_t ts;							/// Marca de tiempo (ms)
+		uint8_t level;							/// Nivel
+		uint8_t nargs;							/// Numero de argumentos
+		uint8_t text_mask;						/// Argumentos copiados en text (bit i: argumento i)
+		uintptr_t args[MaxArgs];				/// Argumentos en crudo (copiados: posicion en text)
+		char text[DEFERREDLOG_TEXT];			/// Cadenas copiadas, consecutivas y terminadas en 0
+	};
+
+	static Entry _entries[DEFERREDLOG_SIZE];
+	static std::atomic<uint32_t> _wr;			/// Indice de escritura (productores)
+	static uint32_t _rd;						/// Indice de lectura (thread de volcado)
+	static std::atomic<uint32_t> _dropped;		/// Trazas descartadas
+	static std::atomic<bool> _started;			/// Thread de volcado creado
+	static Mutex _drain_mtx;					/// Volcado exclusivo (thread de volcado o drain() directo)
+
+	static void post(Level level, const char* module, const char* fmt, const uintptr_t* args, uint8_t nargs, uint8_t text_mask);
+	static void task();
+
+	template<typename T>
+	static uintptr_t arg(T v) { return (uintptr_t)v; }
+	static uintptr_t arg(Text t) { return (uintptr_t)t.str; }
+	template<typename T>
+	static bool isText(T) { return false; }
+	static bool isText(Text) { return true; }
+};
+
+
+/** Macros de traza diferida, con la misma firma que DEBUG_TRACE_x */
+#if ACTIVEMODULE_DEFERRED_LOG == 1
+#define DEFERRED_TRACE_E(expr, module, fmt, ...)	do{ if(expr){ DeferredLog::log(DeferredLog::LevelError, module, fmt, ##__VA_ARGS__); } }while(0)
+#define DEFERRED_TRACE_W(expr, module, fmt, ...)	do{ if(expr){ DeferredLog::log(DeferredLog::LevelWarning, module, fmt, ##__VA_ARGS__); } }while(0)
+#define DEFERRED_TRACE_I(expr, module, fmt, ...)	do{ if(expr){ DeferredLog::log(DeferredLog::LevelInfo, module, fmt, ##__VA_ARGS__); } }while(0)
+#define DEFERRED_TRACE_D(expr, module, fmt, ...)	do{ if(expr){ DeferredLog::log(DeferredLog::LevelDebug, module, fmt, ##__VA_ARGS__); } }while(0)
+#define DEFERRED_TRACE_V(expr, module, fmt, ...)	do{ if(expr){ DeferredLog::log(DeferredLog::LevelVerbose, module, fmt, ##__VA_ARGS__); } }while(0)
+#define DEFERRED_STR(str)	DeferredLog::copy(str)
+#else
+#define DEFERRED_STR(str)	(str)
+#define DEFERRED_TRACE_E	DEBUG_TRACE_E
+#define DEFERRED_TRACE_W	DEBUG_TRACE_W
+#define DEFERRED_TRACE_I	DEBUG_TRACE_I
+#define DEFERRED_TRACE_D	DEBUG_TRACE_D
+#define DEFERRED_TRACE_V	DEBUG_TRACE_V
+#endif
+
+#endif /*__DeferredLog__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,138 @@
+/*
+ * DirectChannel.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	DirectChannel es un canal tipado punto a punto hacia el mailbox de un ActiveModule conocido. Cada envio crea un
+ *	mensaje gestionado en el modulo destino (newMessage) con una copia de los datos y lo postea directamente en su
+ *	putMessage, sin formatear el topic, sin la busqueda de suscriptores del broker y sin la comparacion de topics en
+ *	subscriptionCb. El modulo destino recibe la senal del canal en su maquina de estados y obtiene los datos con
+ *	getMsgData<T>().
+ *
+ *	Opcionalmente el canal replica cada envio en un topic del broker (setMirror), de forma que los observadores
+ *	existentes sigan recibiendo los datos. El modulo destino no debe estar suscrito a ese topic, ya que recibiria
+ *	los datos dos veces.
+ *
+ *	Ejemplo:
+ *		DirectChannel<Sample> ch(filter, Filter::SampleEvt, ActiveModule::LaneUrgent);
+ *		ch.setMirror("stat/sample/sensor", &_publicationCb);
+ *		ch.send(sample);
+ */
+
+#ifndef __DirectChannel__H
+#define __DirectChannel__H
+
+#include "mbed.h"
+#include "ActiveModule.h"
+#include <atomic>
+
+
+template<typename T>
+class DirectChannel {
+  public:
+
+	/** Estadisticas del canal */
+	struct Stats {
+		uint32_t sent;							/// Mensajes entregados al mailbox destino
+		uint32_t failed;						/// Mensajes no entregados (sin memoria o rechazados)
+		uint32_t mirrored;						/// Mensajes replicados en el broker
+	};
+
+
+    /** Constructor
+     *  @param target Modulo destino (NULL: canal sin conectar, ver connect)
+     *  @param sig Senal de los mensajes en el modulo destino
+     *  @param lane Carril de prioridad en el modulo destino
+     */
+	DirectChannel(ActiveModule* target = NULL, uint32_t sig = 0, uint8_t lane = ActiveModule::LaneNormal) :
+			_sent(0), _failed(0), _mirrored(0) {
+		_mirror_topic = NULL;
+		_mirror_cb = NULL;
+		connect(target, sig, lane);
+	}
+
+
+    /** Conecta el canal con un modulo destino
+     *  @param target Modulo destino
+     *  @param sig Senal de los mensajes en el modulo destino
+     *  @param lane Carril de prioridad en el modulo destino
+     */
+	void connect(ActiveModule* target, uint32_t sig, uint8_t lane = ActiveModule::LaneNormal){
+		_target = target;
+		_sig = sig;
+		_lane = lane;
+	}
+
+
+    /** Habilita la replica de los envios en un topic del broker
+     *  @param topic Topic completo (persistente, NULL: deshabilita la replica)
+     *  @param cb Callback de publicacion
+     */
+	void setMirror(const char* topic, MQ::PublishCallback* cb){
+		_mirror_topic = topic;
+		_mirror_cb = cb;
+	}
+
+
+    /** Chequea si el canal esta conectado
+     *  @return True: conectado
+     */
+	bool connected() const {
+		return _target != NULL;
+	}
+
+
+    /** Envia una copia de los datos al modulo destino y, si esta habilitada, al topic de replica. ISR-safe si
+     *  no hay replica: desde ISR, si T no cabe en el bloque del mensaje, el destino debe tener un MsgPool con una
+     *  clase adecuada, ya que no se recurre al heap (el envio falla con osErrorResource).
+     *  @param data Datos
+     *  @return Resultado de putMessage en el destino (osErrorResource: sin memoria, osErrorParameter: sin conectar)
+     */
+	osStatus send(const T& data){
+		if(!_target){
+			return osErrorParameter;
+		}
+		if(_mirror_topic && MQ::MQClient::publish(_mirror_topic, (void*)&data, sizeof(T), _mirror_cb) == MQ::SUCCESS){
+			_mirrored++;
+		}
+		State::Msg* msg = _target->newMessage(_sig, &data, sizeof(T));
+		if(!msg){
+			_failed++;
+			return osErrorResource;
+		}
+		osStatus ost = _target->putMessage(msg, _lane);
+		if(ost == osOK){
+			_sent++;
+		}
+		else{
+			_failed++;
+		}
+		return ost;
+	}
+
+
+    /** Obtiene las estadisticas del canal
+     *  @param stats Recibe las estadisticas
+     */
+	void getStats(Stats& stats) const {
+		stats.sent = _sent;
+		stats.failed = _failed;
+		stats.mirrored = _mirrored;
+	}
+
+  private:
+
+	ActiveModule* _target;						/// Modulo destino
+	uint32_t _sig;								/// Senal en el modulo destino
+	uint8_t _lane;								/// Carril en el modulo destino
+	const char* _mirror_topic;					/// Topic de replica
+	MQ::PublishCallback* _mirror_cb;			/// Callback de publicacion de la replica
+	std::atomic<uint32_t> _sent;
+	std::atomic<uint32_t> _failed;
+	std::atomic<uint32_t> _mirrored;
+};
+
+#endif /*__DirectChannel__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,125 @@
+/*
+ * MPSCQueue.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	MPSCQueue es una cola circular acotada, libre de bloqueos (lock-free), de multiples productores y un
+ *	consumidor. Almacena punteros a objetos de tipo T.
+ *
+ *	Cada posicion de la cola dispone de un numero de secuencia que indica si esta libre o si contiene un dato
+ *	publicado. Los productores reservan una posicion mediante CAS sobre el indice de escritura y publican el dato
+ *	actualizando la secuencia de esa posicion. La extraccion tambien utiliza CAS sobre el indice de lectura, de
+ *	forma que un productor puede descartar el elemento mas antiguo (get) concurrentemente con el consumidor.
+ *
+ *	Puede utilizarse desde contexto ISR: un productor nunca espera a otro, como mucho repite su CAS si ha sido
+ *	interrumpido durante la reserva.
+ */
+
+#ifndef __MPSCQueue__H
+#define __MPSCQueue__H
+
+#include "mbed.h"
+#include <atomic>
+
+/** Tamano de la linea de cache utilizado para separar los indices de productor y consumidor */
+#ifndef MPSCQUEUE_CACHE_LINE
+#define MPSCQUEUE_CACHE_LINE	32
+#endif
+
+
+template<typename T, uint32_t Size>
+class MPSCQueue {
+  public:
+
+	static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "MPSCQueue Size debe ser potencia de 2");
+
+    /** Constructor
+     */
+	MPSCQueue() : _wr(0), _rd(0) {
+		for(uint32_t i = 0; i < Size; i++){
+			_slots[i].seq.store(i, std::memory_order_relaxed);
+			_slots[i].data = NULL;
+		}
+	}
+
+
+    /** Inserta un elemento en la cola (multiples productores, ISR-safe)
+     *  @param data Elemento a insertar
+     *  @return True: insertado, False: cola llena
+     */
+	bool put(T* data){
+		uint32_t pos = _wr.load(std::memory_order_relaxed);
+		for(;;){
+			Slot& s = _slots[pos & (Size - 1)];
+			int32_t dif = (int32_t)(s.seq.load(std::memory_order_acquire) - pos);
+			if(dif == 0){
+				if(_wr.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+					s.data = data;
+					s.seq.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if(dif < 0){
+				return false;
+			}
+			else{
+				pos = _wr.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+
+    /** Extrae el elemento mas antiguo (consumidor, o productor que descarta el mas antiguo; ISR-safe)
+     *  @return Elemento extraido o NULL si no hay ninguno publicado
+     */
+	T* get(){
+		uint32_t pos = _rd.load(std::memory_order_relaxed);
+		for(;;){
+			Slot& s = _slots[pos & (Size - 1)];
+			int32_t dif = (int32_t)(s.seq.load(std::memory_order_acquire) - (pos + 1));
+			if(dif == 0){
+				if(_rd.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+					T* data = s.data;
+					s.seq.store(pos + Size, std::memory_order_release);
+					return data;
+				}
+			}
+			else if(dif < 0){
+				return NULL;
+			}
+			else{
+				pos = _rd.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+
+    /** Obtiene el numero de elementos reservados en la cola (aproximado si hay productores activos)
+     *  @return Numero de elementos
+     */
+	uint32_t count() const {
+		return _wr.load(std::memory_order_relaxed) - _rd.load(std::memory_order_relaxed);
+	}
+
+
+    /** Obtiene la capacidad de la cola
+     *  @return Capacidad
+     */
+	static uint32_t capacity() { return Size; }
+
+  private:
+
+	struct Slot {
+		std::atomic<uint32_t> seq;				/// Secuencia de la posicion
+		T* data;								/// Dato almacenado
+	};
+
+	alignas(MPSCQUEUE_CACHE_LINE) std::atomic<uint32_t> _wr;	/// Indice de escritura (productores)
+	alignas(MPSCQUEUE_CACHE_LINE) std::atomic<uint32_t> _rd;	/// Indice de lectura (consumidor)
+	alignas(MPSCQUEUE_CACHE_LINE) Slot _slots[Size];			/// Posiciones de la cola
+};
+
+#endif /*__MPSCQueue__H */
+
+/**** END OF FILE ****/
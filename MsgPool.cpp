@@ -0,0 +1,188 @@
+/*
+ * MsgPool.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "MsgPool.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+MsgPool* MsgPool::_first = NULL;
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+MsgPool::MsgPool(const SizeClass* classes, uint8_t num_classes){
+	_num_classes = (num_classes > MaxSizeClasses)? MaxSizeClasses : num_classes;
+	_allocs = 0;
+	_frees = 0;
+	_heap_allocs = 0;
+	_heap_frees = 0;
+	for(uint8_t i = 0; i < _num_classes; i++){
+		Class& c = _classes[i];
+		// los bloques se alinean a 8 bytes y deben poder alojar el enlace de la lista libre
+		c.block_size = (classes[i].block_size < sizeof(Block))? sizeof(Block) : classes[i].block_size;
+		c.block_size = (c.block_size + 7) & ~7;
+		c.num_blocks = classes[i].num_blocks;
+		c.mem = (uint8_t*)Heap::memAlloc(c.block_size * c.num_blocks);
+		MBED_ASSERT(c.mem);
+		c.free_list = NULL;
+		for(int32_t b = c.num_blocks - 1; b >= 0; b--){
+			Block* blk = (Block*)&c.mem[b * c.block_size];
+			blk->next = c.free_list;
+			c.free_list = blk;
+		}
+		c.in_use = 0;
+		c.peak = 0;
+		c.exhausted = 0;
+	}
+	core_util_critical_section_enter();
+	_next = _first;
+	_first = this;
+	core_util_critical_section_exit();
+}
+
+
+//------------------------------------------------------------------------------------
+MsgPool::~MsgPool(){
+	core_util_critical_section_enter();
+	MsgPool** pp = &_first;
+	while(*pp && *pp != this){
+		pp = &(*pp)->_next;
+	}
+	if(*pp){
+		*pp = _next;
+	}
+	core_util_critical_section_exit();
+	for(uint8_t i = 0; i < _num_classes; i++){
+		Heap::memFree(_classes[i].mem);
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+void* MsgPool::alloc(size_t size, bool heap_fallback){
+	core_util_critical_section_enter();
+	for(uint8_t i = 0; i < _num_classes; i++){
+		Class& c = _classes[i];
+		if(size > c.block_size){
+			continue;
+		}
+		if(c.free_list){
+			Block* blk = c.free_list;
+			c.free_list = blk->next;
+			if(++c.in_use > c.peak){
+				c.peak = c.in_use;
+			}
+			_allocs++;
+			core_util_critical_section_exit();
+			return blk;
+		}
+		// clase agotada, se prueba con la siguiente
+		c.exhausted++;
+	}
+	// el heap no es utilizable desde ISR
+	if(!heap_fallback || IS_ISR()){
+		core_util_critical_section_exit();
+		return NULL;
+	}
+	_heap_allocs++;
+	core_util_critical_section_exit();
+	return Heap::memAlloc(size);
+}
+
+
+//------------------------------------------------------------------------------------
+void MsgPool::free(void* ptr){
+	if(!ptr){
+		return;
+	}
+	int i = findClass(ptr);
+	if(i < 0){
+		core_util_critical_section_enter();
+		_heap_frees++;
+		core_util_critical_section_exit();
+		Heap::memFree(ptr);
+		return;
+	}
+	Class& c = _classes[i];
+	Block* blk = (Block*)ptr;
+	core_util_critical_section_enter();
+	blk->next = c.free_list;
+	c.free_list = blk;
+	c.in_use--;
+	_frees++;
+	core_util_critical_section_exit();
+}
+
+
+//------------------------------------------------------------------------------------
+bool MsgPool::ownsBlock(const void* ptr, size_t size) const {
+	uintptr_t p = (uintptr_t)ptr;
+	for(uint8_t i = 0; i < _num_classes; i++){
+		const Class& c = _classes[i];
+		uintptr_t mem = (uintptr_t)c.mem;
+		if(p >= mem && p < mem + c.block_size * c.num_blocks){
+			return (c.block_size >= size && (p - mem) % c.block_size == 0);
+		}
+	}
+	return false;
+}
+
+
+//------------------------------------------------------------------------------------
+MsgPool* MsgPool::findBlock(const void* ptr, size_t size){
+	// los pools se crean en la inicializacion y no se destruyen mientras haya mensajes, por lo que la lista se
+	// recorre sin seccion critica
+	for(MsgPool* pool = _first; pool; pool = pool->_next){
+		if(pool->ownsBlock(ptr, size)){
+			return pool;
+		}
+	}
+	return NULL;
+}
+
+
+//------------------------------------------------------------------------------------
+void MsgPool::getStats(Stats& stats) const {
+	core_util_critical_section_enter();
+	stats.allocs = _allocs;
+	stats.frees = _frees;
+	stats.heap_allocs = _heap_allocs;
+	stats.heap_frees = _heap_frees;
+	stats.num_classes = _num_classes;
+	for(uint8_t i = 0; i < _num_classes; i++){
+		stats.classes[i].block_size = _classes[i].block_size;
+		stats.classes[i].num_blocks = _classes[i].num_blocks;
+		stats.classes[i].in_use = _classes[i].in_use;
+		stats.classes[i].peak = _classes[i].peak;
+		stats.classes[i].exhausted = _classes[i].exhausted;
+	}
+	core_util_critical_section_exit();
+}
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE METHODS IMPLEMENTATION --------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+int MsgPool::findClass(const void* ptr) const {
+	const uint8_t* p = (const uint8_t*)ptr;
+	for(uint8_t i = 0; i < _num_classes; i++){
+		const Class& c = _classes[i];
+		if(p >= c.mem && p < &c.mem[c.block_size * c.num_blocks]){
+			return i;
+		}
+	}
+	return -1;
+}
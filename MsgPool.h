@@ -0,0 +1,150 @@
+/*
+ * MsgPool.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	MsgPool es un gestor de bloques de memoria de tamano fijo, organizado en clases de tamano, para alojar los
+ *	mensajes State::Msg y sus datos asociados sin recurrir al heap general en cada evento.
+ *
+ *	Cada clase de tamano reserva todos sus bloques una unica vez durante la construccion. La reserva y liberacion
+ *	de bloques son O(1) (lista libre intrusiva) y pueden invocarse desde ISR. Si no hay una clase adecuada o esta
+ *	agotada, se recurre al heap y se contabiliza el evento, salvo desde ISR, donde la reserva falla. Los bloques
+ *	obtenidos del heap no pueden liberarse desde ISR.
+ *
+ *	Todos los pools se registran en una lista global, de forma que findBlock identifique por rango de direcciones
+ *	el pool y la clase a la que pertenece un bloque sin acceder a su contenido.
+ */
+
+#ifndef __MsgPool__H
+#define __MsgPool__H
+
+#include "mbed.h"
+#include "MQLib.h"
+
+
+class MsgPool {
+  public:
+
+	/** Maximo numero de clases de tamano */
+	static const uint8_t MaxSizeClasses = 4;
+
+	/** Descripcion de una clase de tamano */
+	struct SizeClass {
+		uint16_t block_size;					/// Tamano de cada bloque en bytes
+		uint16_t num_blocks;					/// Numero de bloques de la clase
+	};
+
+	/** Estadisticas de una clase de tamano */
+	struct ClassStats {
+		uint16_t block_size;					/// Tamano de bloque
+		uint16_t num_blocks;					/// Numero de bloques
+		uint16_t in_use;						/// Bloques en uso
+		uint16_t peak;							/// Maximo de bloques en uso
+		uint32_t exhausted;						/// Veces que la clase estaba agotada
+	};
+
+	/** Estadisticas del gestor */
+	struct Stats {
+		uint32_t allocs;						/// Reservas servidas por el pool
+		uint32_t frees;							/// Liberaciones devueltas al pool
+		uint32_t heap_allocs;					/// Reservas servidas por el heap (fallback)
+		uint32_t heap_frees;					/// Liberaciones devueltas al heap
+		uint8_t num_classes;					/// Numero de clases
+		ClassStats classes[MaxSizeClasses];		/// Estadisticas por clase
+	};
+
+
+    /** Constructor. Las clases deben estar ordenadas por tamano de bloque creciente.
+     *  @param classes Clases de tamano
+     *  @param num_classes Numero de clases (max MaxSizeClasses)
+     */
+	MsgPool(const SizeClass* classes, uint8_t num_classes);
+
+
+    /** Destructor
+     */
+	~MsgPool();
+
+
+    /** Reserva un bloque con capacidad para 'size' bytes
+     *  @param size Tamano requerido
+     *  @param heap_fallback False: no recurre al heap si no hay una clase adecuada con bloques libres. Desde ISR
+     *  nunca se recurre al heap.
+     *  @return Puntero al bloque o NULL si tampoco hay memoria en el heap
+     */
+	void* alloc(size_t size, bool heap_fallback = true);
+
+
+    /** Libera un bloque obtenido con alloc. ISR-safe salvo para los bloques obtenidos del heap.
+     *  @param ptr Bloque a liberar (se admite NULL)
+     */
+	void free(void* ptr);
+
+
+    /** Chequea si un bloque pertenece a alguna de las clases del pool
+     *  @param ptr Bloque
+     *  @return True si pertenece al pool
+     */
+	bool owns(const void* ptr) const { return (findClass(ptr) >= 0); }
+
+
+    /** Chequea si una direccion es el inicio de un bloque de alguna clase de al menos 'size' bytes. Solo compara
+     *  direcciones, por lo que admite cualquier puntero.
+     *  @param ptr Direccion
+     *  @param size Tamano minimo de bloque
+     *  @return True si es el inicio de un bloque del pool
+     */
+	bool ownsBlock(const void* ptr, size_t size) const;
+
+
+    /** Busca, entre todos los pools creados, aquel en el que una direccion es el inicio de un bloque de al menos
+     *  'size' bytes. ISR-safe.
+     *  @param ptr Direccion
+     *  @param size Tamano minimo de bloque
+     *  @return Pool al que pertenece el bloque o NULL
+     */
+	static MsgPool* findBlock(const void* ptr, size_t size);
+
+
+    /** Obtiene una copia de las estadisticas
+     *  @param stats Receptor de las estadisticas
+     */
+	void getStats(Stats& stats) const;
+
+  private:
+
+	struct Block {
+		Block* next;							/// Siguiente bloque libre
+	};
+
+	struct Class {
+		uint16_t block_size;
+		uint16_t num_blocks;
+		uint8_t* mem;							/// Memoria de los bloques
+		Block* free_list;						/// Lista de bloques libres
+		uint16_t in_use;
+		uint16_t peak;
+		uint32_t exhausted;
+	};
+
+	Class _classes[MaxSizeClasses];
+	uint8_t _num_classes;
+	uint32_t _allocs;
+	uint32_t _frees;
+	uint32_t _heap_allocs;
+	uint32_t _heap_frees;
+	MsgPool* _next;								/// Siguiente pool de la lista global
+
+	static MsgPool* _first;						/// Lista global de pools (findBlock)
+
+    /** Busca la clase a la que pertenece un bloque
+     *  @param ptr Bloque
+     *  @return Indice de la clase o -1 si no pertenece al pool
+     */
+	int findClass(const void* ptr) const;
+};
+
+#endif /*__MsgPool__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,247 @@
+/*
+ * ParamCache.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "ParamCache.h"
+#include "MQLib.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+ParamCache::ParamCache(FSManager* fs, uint8_t max_entries, uint32_t flush_millis){
+	_fs = fs;
+	_max_entries = max_entries;
+	_flush_millis = flush_millis;
+	_dirty = 0;
+	_dirty_since = 0;
+	_entries = new Entry[max_entries]();
+	MBED_ASSERT(_entries);
+}
+
+
+//------------------------------------------------------------------------------------
+ParamCache::~ParamCache(){
+	flush();
+	for(uint8_t i = 0; i < _max_entries; i++){
+		if(_entries[i].data){
+			Heap::memFree(_entries[i].data);
+		}
+	}
+	delete[] _entries;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ParamCache::save(const char* param_id, void* data, size_t size, NVSInterface::KeyValueType type){
+	_mtx.lock();
+	Entry* e = find(param_id, true);
+	bool result;
+	if(e && store(e, data, size, type)){
+		e->flags &= ~EntryRemoved;
+		markDirty(e);
+		result = true;
+	}
+	else{
+		// sin espacio en cache: se descarta el valor pendiente, si lo hay, y se graba directamente
+		if(e){
+			release(e);
+		}
+		result = writeThrough(param_id, data, size, type);
+	}
+	_mtx.unlock();
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ParamCache::restore(const char* param_id, void* data, size_t size, NVSInterface::KeyValueType type){
+	_mtx.lock();
+	Entry* e = find(param_id, false);
+	if(e && (e->flags & EntryRemoved)){
+		_mtx.unlock();
+		return false;
+	}
+	if(e && (e->flags & EntryValid) && e->size == size){
+		memcpy(data, e->data, size);
+		_mtx.unlock();
+		return true;
+	}
+	// el valor pendiente de volcado prevalece sobre el de memoria NV, aunque su tamano no coincida
+	if(e && (e->flags & EntryDirty)){
+		_mtx.unlock();
+		return false;
+	}
+	// primera lectura: se recupera de memoria NV y se guarda en cache
+	bool result = false;
+	if(_fs->open()){
+		result = (_fs->restore(param_id, data, size, type) == osOK);
+		_fs->close();
+	}
+	if(result && (e || (e = find(param_id, true)) != NULL)){
+		store(e, data, size, type);
+	}
+	_mtx.unlock();
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ParamCache::remove(const char* param_id){
+	_mtx.lock();
+	Entry* e = find(param_id, true);
+	bool result = true;
+	if(e){
+		e->flags = (e->flags & ~EntryValid) | EntryRemoved;
+		markDirty(e);
+	}
+	else{
+		result = writeThrough(param_id, NULL, 0, NVSInterface::TypeBlob);
+	}
+	_mtx.unlock();
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ParamCache::flush(){
+	_mtx.lock();
+	if(!_dirty){
+		_mtx.unlock();
+		return true;
+	}
+	if(!_fs->open()){
+		// memoria NV no disponible: se reintenta en el siguiente plazo, no en cada ciclo del thread
+		_dirty_since = (uint32_t)Kernel::get_ms_count();
+		_mtx.unlock();
+		return false;
+	}
+	bool result = true;
+	for(uint8_t i = 0; i < _max_entries; i++){
+		Entry& e = _entries[i];
+		if(!(e.flags & EntryDirty)){
+			continue;
+		}
+		int err = (e.flags & EntryRemoved)? _fs->removeKey(e.id) : _fs->save(e.id, e.data, e.size, e.type);
+		if(err != osOK){
+			result = false;
+			continue;
+		}
+		e.flags &= ~EntryDirty;
+		_dirty--;
+		// el borrado ya esta en memoria NV: la entrada queda libre
+		if(e.flags & EntryRemoved){
+			release(&e);
+		}
+	}
+	_fs->close();
+	// los cambios que no se han podido volcar se reintentan en el siguiente plazo
+	_dirty_since = (uint32_t)Kernel::get_ms_count();
+	_mtx.unlock();
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t ParamCache::millisToFlush(){
+	_mtx.lock();
+	uint32_t millis = osWaitForever;
+	if(_dirty){
+		uint32_t elapsed = (uint32_t)Kernel::get_ms_count() - _dirty_since;
+		millis = (elapsed >= _flush_millis)? 0 : (_flush_millis - elapsed);
+	}
+	_mtx.unlock();
+	return millis;
+}
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE METHODS IMPLEMENTATION --------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+ParamCache::Entry* ParamCache::find(const char* param_id, bool create){
+	Entry* free_entry = NULL;
+	for(uint8_t i = 0; i < _max_entries; i++){
+		if(_entries[i].id[0] == 0){
+			if(!free_entry){
+				free_entry = &_entries[i];
+			}
+		}
+		else if(strncmp(_entries[i].id, param_id, MaxKeyLength) == 0){
+			return &_entries[i];
+		}
+	}
+	if(!create || !free_entry || strlen(param_id) >= MaxKeyLength){
+		return NULL;
+	}
+	strcpy(free_entry->id, param_id);
+	free_entry->flags = 0;
+	free_entry->size = 0;
+	free_entry->data = NULL;
+	return free_entry;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ParamCache::store(Entry* e, const void* data, size_t size, NVSInterface::KeyValueType type){
+	if(!e->data || e->size != size){
+		uint8_t* buf = (uint8_t*)Heap::memAlloc(size);
+		if(!buf){
+			return false;
+		}
+		if(e->data){
+			Heap::memFree(e->data);
+		}
+		e->data = buf;
+		e->size = size;
+	}
+	memcpy(e->data, data, size);
+	e->type = type;
+	e->flags |= EntryValid;
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void ParamCache::release(Entry* e){
+	if(e->flags & EntryDirty){
+		_dirty--;
+	}
+	if(e->data){
+		Heap::memFree(e->data);
+	}
+	e->id[0] = 0;
+	e->flags = 0;
+	e->size = 0;
+	e->data = NULL;
+}
+
+
+//------------------------------------------------------------------------------------
+bool ParamCache::writeThrough(const char* param_id, void* data, size_t size, NVSInterface::KeyValueType type){
+	if(!_fs->open()){
+		return false;
+	}
+	int err = (data)? _fs->save(param_id, data, size, type) : _fs->removeKey(param_id);
+	_fs->close();
+	return (err == osOK);
+}
+
+
+//------------------------------------------------------------------------------------
+void ParamCache::markDirty(Entry* e){
+	if(!(e->flags & EntryDirty)){
+		e->flags |= EntryDirty;
+		if(_dirty++ == 0){
+			_dirty_since = (uint32_t)Kernel::get_ms_count();
+		}
+	}
+}
@@ -0,0 +1,127 @@
+/*
+ * ParamCache.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	ParamCache es una cache en RAM de parametros almacenados en memoria NV, con escritura diferida. Las lecturas se
+ *	sirven desde RAM (salvo la primera de cada parametro), y las escrituras y borrados se marcan como pendientes y se
+ *	vuelcan todos juntos en una unica transaccion open/save.../close, bien al vencer el plazo de volcado o bien al
+ *	invocar flush(). Puede ser propia de un modulo o compartida entre varios.
+ *
+ *	Los parametros que no caben en la cache (tabla llena, identificador de MaxKeyLength o mas caracteres o sin
+ *	memoria para sus datos) se graban y borran directamente en memoria NV. Las entradas borradas se liberan al
+ *	volcar el borrado.
+ */
+
+#ifndef __ParamCache__H
+#define __ParamCache__H
+
+#include "mbed.h"
+#include "FSManager.h"
+
+
+class ParamCache {
+  public:
+
+	/** Tamano maximo de los identificadores de parametros (incluyendo el terminador) */
+	static const uint8_t MaxKeyLength = 16;
+
+
+    /** Constructor
+     *  @param fs Gestor del sistema de backup en memoria NVS
+     *  @param max_entries Maximo numero de parametros en cache
+     *  @param flush_millis Plazo maximo desde la primera escritura pendiente hasta su volcado
+     */
+	ParamCache(FSManager* fs, uint8_t max_entries, uint32_t flush_millis);
+
+
+    /** Destructor
+     */
+	~ParamCache();
+
+
+    /** Graba un parametro en la cache, quedando pendiente de volcado
+     * 	@param param_id Identificador del parametro
+     * 	@param data Datos asociados
+     * 	@param size Tamano de los datos
+     * 	@param type Tipo de los datos
+     * 	@return True: exito, False: no se pudo grabar en memoria NV (parametro fuera de cache)
+     */
+	bool save(const char* param_id, void* data, size_t size, NVSInterface::KeyValueType type);
+
+
+    /** Recupera un parametro, desde la cache o, si no esta, desde memoria NV (quedando en cache)
+     * 	@param param_id Identificador del parametro
+     * 	@param data Receptor de los datos asociados
+     * 	@param size Tamano de los datos a recibir
+     * 	@param type Tipo de los datos
+     * 	@return True: exito, False: no se pudo recuperar (o hay una escritura pendiente de otro tamano)
+     */
+	bool restore(const char* param_id, void* data, size_t size, NVSInterface::KeyValueType type);
+
+
+    /** Elimina un parametro, quedando pendiente de volcado
+     * 	@param param_id Identificador del parametro
+     * 	@return True: exito, False: no se pudo borrar de memoria NV (parametro fuera de cache)
+     */
+	bool remove(const char* param_id);
+
+
+    /** Vuelca todos los cambios pendientes en una unica transaccion
+     * 	@return True: exito, False: algun cambio no se pudo volcar (queda pendiente)
+     */
+	bool flush();
+
+
+    /** Vuelca los cambios pendientes si ha vencido su plazo
+     */
+	void flushIfDue(){
+		if(millisToFlush() == 0){
+			flush();
+		}
+	}
+
+
+    /** Obtiene el tiempo restante hasta el plazo de volcado
+     * 	@return Milisegundos (osWaitForever si no hay cambios pendientes)
+     */
+	uint32_t millisToFlush();
+
+  private:
+
+	/** Flags de estado de una entrada */
+	enum EntryFlags{
+		EntryValid = (1 << 0),				/// Datos validos en cache
+		EntryDirty = (1 << 1),				/// Escritura pendiente de volcado
+		EntryRemoved = (1 << 2),			/// Borrado pendiente de volcado
+	};
+
+	struct Entry {
+		char id[MaxKeyLength];					/// Identificador (vacio: entrada libre)
+		uint8_t flags;							/// EntryFlags
+		NVSInterface::KeyValueType type;		/// Tipo de los datos
+		uint16_t size;							/// Tamano de los datos
+		uint8_t* data;							/// Datos
+	};
+
+	FSManager* _fs;
+	Entry* _entries;
+	uint8_t _max_entries;
+	uint32_t _flush_millis;
+	uint8_t _dirty;								/// Numero de entradas pendientes de volcado
+	uint32_t _dirty_since;						/// Instante del primer cambio pendiente o del ultimo volcado fallido
+	Mutex _mtx;									/// Acceso exclusivo (cache compartible entre modulos)
+
+	Entry* find(const char* param_id, bool create);
+	bool store(Entry* e, const void* data, size_t size, NVSInterface::KeyValueType type);
+	void markDirty(Entry* e);
+	void release(Entry* e);
+
+    /** Graba (o borra, si data es NULL) un parametro directamente en memoria NV, sin pasar por la cache */
+	bool writeThrough(const char* param_id, void* data, size_t size, NVSInterface::KeyValueType type);
+};
+
+#endif /*__ParamCache__H */
+
+/**** END OF FILE ****/
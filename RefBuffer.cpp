@@ -0,0 +1,75 @@
+/*
+ * RefBuffer.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "RefBuffer.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+MsgPool* RefBuffer::_pool = NULL;
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+void* RefBuffer::create(uint16_t size){
+	size_t total = sizeof(Header) + size;
+	Header* hdr = (Header*)((_pool)? _pool->alloc(total) : Heap::memAlloc(total));
+	if(!hdr){
+		return NULL;
+	}
+	hdr->tag = Tag ^ (uint32_t)(uintptr_t)hdr;
+	hdr->refs.store(1, std::memory_order_relaxed);
+	hdr->size = size;
+	return hdr->data;
+}
+
+
+//------------------------------------------------------------------------------------
+bool RefBuffer::isShared(const void* data){
+	if(!data || !_pool){
+		return false;
+	}
+	Header* hdr = getHeader(data);
+	// se comprueba que la cabecera es el inicio de un bloque del pool antes de acceder a ella
+	return (_pool->ownsBlock(hdr, sizeof(Header)) && hdr->tag == (Tag ^ (uint32_t)(uintptr_t)hdr));
+}
+
+
+//------------------------------------------------------------------------------------
+bool RefBuffer::retain(void* data){
+	if(!isShared(data)){
+		return false;
+	}
+	getHeader(data)->refs.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void RefBuffer::release(void* data){
+	if(!data){
+		return;
+	}
+	Header* hdr = getHeader(data);
+	MBED_ASSERT(hdr->tag == (Tag ^ (uint32_t)(uintptr_t)hdr));
+	if(hdr->refs.fetch_sub(1, std::memory_order_acq_rel) != 1){
+		return;
+	}
+	hdr->tag = 0;
+	if(_pool){
+		// MsgPool redirige al heap los bloques que no le pertenecen
+		_pool->free(hdr);
+	}
+	else{
+		Heap::memFree(hdr);
+	}
+}
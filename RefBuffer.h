@@ -0,0 +1,101 @@
+/*
+ * RefBuffer.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	RefBuffer gestiona buffers de datos con contador de referencias, para publicar un mismo bloque de datos a
+ *	varios suscriptores sin copiarlo. Se opera siempre con el puntero a los datos (el mismo que viaja por MQLib),
+ *	la cabecera con el contador se aloja justo antes.
+ *
+ *	Los buffers se reservan del MsgPool asignado con setPool (por defecto, el que crea ActiveModule con el primer
+ *	modulo, ver ACTIVEMODULE_REF_BUFFERS). Solo esos buffers pueden ser retenidos por los suscriptores (retain), ya
+ *	que su pertenencia se comprueba por inicio de bloque del pool. Sin pool, o si esta agotado o el buffer no cabe
+ *	en sus bloques, el buffer se reserva del heap y los suscriptores deben copiar los datos como hasta ahora.
+ */
+
+#ifndef __RefBuffer__H
+#define __RefBuffer__H
+
+#include "mbed.h"
+#include "MsgPool.h"
+#include <atomic>
+
+
+class RefBuffer {
+  public:
+
+    /** Asigna el gestor de bloques compartido por todos los buffers
+     *  @param pool Gestor de bloques
+     */
+	static void setPool(MsgPool* pool) { _pool = pool; }
+
+
+    /** Obtiene el gestor de bloques asignado
+     *  @return Gestor de bloques o NULL si no hay ninguno
+     */
+	static MsgPool* getPool() { return _pool; }
+
+
+    /** Obtiene el tamano de bloque necesario para un buffer (cabecera incluida)
+     *  @param size Tamano de los datos
+     *  @return Tamano del bloque
+     */
+	static size_t blockSize(uint16_t size) { return offsetof(Header, data) + size; }
+
+
+    /** Crea un buffer con una referencia (la del creador)
+     *  @param size Tamano de los datos
+     *  @return Puntero a los datos o NULL si no hay memoria
+     */
+	static void* create(uint16_t size);
+
+
+    /** Chequea si unos datos recibidos pertenecen a un buffer compartible
+     *  @param data Datos
+     *  @return True si pueden retenerse con retain
+     */
+	static bool isShared(const void* data);
+
+
+    /** Anade una referencia a un buffer compartible
+     *  @param data Datos
+     *  @return True si se ha retenido, False si no es un buffer compartible (el llamante debe copiarlo)
+     */
+	static bool retain(void* data);
+
+
+    /** Libera una referencia. Al liberar la ultima, el buffer se devuelve a su origen.
+     *  @param data Datos obtenidos con create o retenidos con retain
+     */
+	static void release(void* data);
+
+
+    /** Obtiene el tamano de los datos de un buffer
+     *  @param data Datos
+     *  @return Tamano
+     */
+	static uint16_t size(const void* data) { return getHeader(data)->size; }
+
+  private:
+
+	/** Marca de los buffers validos */
+	static const uint32_t Tag = 0x52454642;
+
+	struct Header {
+		uint32_t tag;							/// Tag ^ direccion de la cabecera
+		std::atomic<uint16_t> refs;				/// Contador de referencias
+		uint16_t size;							/// Tamano de los datos
+		MBED_ALIGN(8) uint8_t data[];			/// Datos
+	};
+
+	static MsgPool* _pool;						/// Gestor de bloques compartido
+
+	static Header* getHeader(const void* data){
+		return (Header*)((uint8_t*)data - offsetof(Header, data));
+	}
+};
+
+#endif /*__RefBuffer__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,257 @@
+/*
+ * StateTable.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	StateTable es una maquina de estados declarativa, opcional, para modulos con muchos estados y senales. Se
+ *	describe mediante una tabla de estados (acciones de entrada y salida) y una tabla de transiciones
+ *	(estado, senal) -> (guarda, accion, estado destino), ambas constantes. La tabla de transiciones se resuelve en
+ *	tiempo de compilacion (index) en una matriz densa estado x senal, de forma que el despacho de un evento y las
+ *	transiciones son accesos directos a arrays constantes, sin llamadas virtuales ni Callback intermedios. Las
+ *	transiciones con un estado, senal o destino fuera de rango son un error de compilacion.
+ *
+ *	Convive con el estilo de manejadores existente: el modulo mantiene su estado Init de StateMachine y delega en
+ *	la tabla los eventos recibidos en Init_EventHandler. Las senales siguen el convenio de los modulos
+ *	(State::EV_RESERVED_USER << i, i < ActiveModule::MaxUserSignals), indexandose por la posicion de su bit.
+ *
+ *	Las transiciones con el mismo estado y senal deben ser consecutivas; se evalua la primera cuya guarda se
+ *	cumpla (o no tenga guarda). Con target = Internal se ejecuta la accion sin salir del estado.
+ *
+ *	Ejemplo:
+ *		class Motor : public ActiveModule {
+ *			enum MotorState { StIdle, StRunning, NumStates };
+ *			typedef StateTable<Motor, NumStates, 2> Fsm;
+ *			void startPwm(); void stopPwm(); bool isArmed(State::Msg*); void setSpeed(State::Msg*);
+ *			static const Fsm::StateDef States[NumStates];
+ *			static constexpr Fsm::Transition Transitions[] = {
+ *				{ StIdle, StartEvt, &Motor::isArmed, &Motor::setSpeed, StRunning },
+ *				{ StRunning, StopEvt, NULL, NULL, StIdle },
+ *				{ StRunning, StartEvt, NULL, &Motor::setSpeed, Fsm::Internal },
+ *			};
+ *			static constexpr Fsm::Index TransitionIndex = Fsm::index(Transitions);
+ *			Fsm _fsm;
+ *			...
+ *			State::StateResult Init_EventHandler(State::StateEvent* se){ return _fsm.dispatch(se); }
+ *			uint8_t traceState(){ return _fsm.current(); }
+ *		};
+ *
+ *		const Motor::Fsm::StateDef Motor::States[] = {
+ *			{ NULL, NULL },								// StIdle
+ *			{ &Motor::startPwm, &Motor::stopPwm },		// StRunning
+ *		};
+ *		constexpr Motor::Fsm::Transition Motor::Transitions[];
+ *		constexpr Motor::Fsm::Index Motor::TransitionIndex;
+ *
+ *		Motor::Motor(...) : ActiveModule(...), _fsm(this, States, TransitionIndex) {}
+ */
+
+#ifndef __StateTable__H
+#define __StateTable__H
+
+#include "mbed.h"
+#include "ActiveModule.h"
+
+
+/** Secuencia de indices 0..N-1 para construir la matriz en tiempo de compilacion (profundidad logaritmica) */
+template<uint16_t... I> struct StateTableSeq {};
+
+template<class A, class B> struct StateTableSeqCat;
+template<uint16_t... A, uint16_t... B> struct StateTableSeqCat<StateTableSeq<A...>, StateTableSeq<B...> > {
+	typedef StateTableSeq<A..., (uint16_t)(sizeof...(A) + B)...> type;
+};
+
+template<uint16_t N> struct StateTableMakeSeq {
+	typedef typename StateTableSeqCat<typename StateTableMakeSeq<N / 2>::type, typename StateTableMakeSeq<N - N / 2>::type>::type type;
+};
+template<> struct StateTableMakeSeq<0> { typedef StateTableSeq<> type; };
+template<> struct StateTableMakeSeq<1> { typedef StateTableSeq<0> type; };
+
+
+template<class Owner, uint8_t NumStates, uint8_t NumSignals>
+class StateTable {
+  public:
+
+	/** Accion de entrada o salida de un estado */
+	typedef void (Owner::*Hook)();
+
+	/** Accion de una transicion */
+	typedef void (Owner::*Action)(State::Msg* msg);
+
+	/** Guarda de una transicion */
+	typedef bool (Owner::*Guard)(State::Msg* msg);
+
+	/** Definicion de un estado */
+	struct StateDef {
+		Hook entry;								/// Accion de entrada (NULL: ninguna)
+		Hook exit;								/// Accion de salida (NULL: ninguna)
+	};
+
+	/** Transicion */
+	struct Transition {
+		uint8_t state;							/// Estado origen
+		uint32_t sig;							/// Senal (State::EV_RESERVED_USER << i)
+		Guard guard;							/// Guarda (NULL: siempre)
+		Action action;							/// Accion (NULL: ninguna)
+		uint8_t target;							/// Estado destino o Internal
+	};
+
+	/** Destino de una transicion interna (sin salida ni entrada) */
+	static const uint8_t Internal = 0xFF;
+
+	static_assert(NumStates > 0 && NumStates < Internal, "StateTable: numero de estados no valido");
+	static_assert(NumSignals > 0 && NumSignals <= ActiveModule::MaxUserSignals, "StateTable: demasiadas senales (ActiveModule::MaxUserSignals)");
+
+	/** Tabla de transiciones resuelta en compilacion (ver index) */
+	struct Index {
+		const Transition* transitions;			/// Transiciones
+		uint8_t num_transitions;				/// Numero de transiciones
+		uint8_t cell[NumStates * NumSignals];	/// Primera transicion de cada (estado, senal)
+	};
+
+
+    /** Resuelve en tiempo de compilacion una tabla de transiciones en la matriz densa estado x senal. Se invoca
+     *  en la inicializacion de un miembro static constexpr.
+     *  @param transitions Transiciones (static constexpr, max 254)
+     *  @return Tabla resuelta
+     */
+	template<uint8_t N>
+	static constexpr Index index(const Transition (&transitions)[N]){
+		static_assert(N < NoTransition, "StateTable: maximo 254 transiciones");
+		return makeIndex(check(transitions, N, 0), N, typename StateTableMakeSeq<NumStates * NumSignals>::type());
+	}
+
+
+    /** Constructor
+     *  @param owner Modulo propietario de las acciones
+     *  @param states Definicion de los estados (persistente)
+     *  @param index Tabla de transiciones resuelta con index (persistente)
+     *  @param initial Estado inicial
+     */
+	StateTable(Owner* owner, const StateDef* states, const Index& index, uint8_t initial = 0) : _index(index) {
+		MBED_ASSERT(initial < NumStates);
+		_owner = owner;
+		_states = states;
+		_current = initial;
+	}
+
+
+    /** Despacha un evento de la maquina de estados del modulo. EV_ENTRY (entrada en el estado Init del modulo)
+     *  ejecuta la entrada del estado actual; el resto de senales se resuelven en la tabla.
+     *  @param se Evento
+     *  @return State::HANDLED si se ejecuta alguna transicion o entrada, State::IGNORED en otro caso
+     */
+	State::StateResult dispatch(State::StateEvent* se){
+		if(se->evt == State::EV_ENTRY){
+			enter(_current);
+			return State::HANDLED;
+		}
+		uint32_t idx = signalIndex((uint32_t)se->evt);
+		if(idx >= NumSignals){
+			return State::IGNORED;
+		}
+		State::Msg* msg = (State::Msg*)se->oe->value.p;
+		for(uint8_t i = _index.cell[_current * NumSignals + idx]; i < _index.num_transitions; i++){
+			const Transition& t = _index.transitions[i];
+			if(t.state != _current || signalIndex(t.sig) != idx){
+				break;
+			}
+			if(t.guard && !(_owner->*t.guard)(msg)){
+				continue;
+			}
+			fire(t, msg);
+			return State::HANDLED;
+		}
+		return State::IGNORED;
+	}
+
+
+    /** Obtiene el estado actual
+     *  @return Estado
+     */
+	uint8_t current() const {
+		return _current;
+	}
+
+  private:
+
+	/** Celda sin transicion */
+	static const uint8_t NoTransition = 0xFF;
+
+	Owner* _owner;
+	const StateDef* _states;
+	const Index& _index;
+	uint8_t _current;
+
+
+	/** Obtiene el indice de una senal por la posicion de su bit
+	 *  @param sig Senal
+	 *  @return Indice (>= NumSignals si no es una senal de usuario)
+	 */
+	static constexpr uint32_t signalIndex(uint32_t sig){
+		return (sig < (uint32_t)State::EV_RESERVED_USER)? NumSignals : (uint32_t)(__builtin_ctz(sig) - __builtin_ctz((uint32_t)State::EV_RESERVED_USER));
+	}
+
+
+	/** Transicion fuera de rango. No es constexpr: invocarla en index produce un error de compilacion */
+	static void invalidTransition() {}
+
+
+	/** Comprueba el rango de las transiciones a partir de la i-esima
+	 *  @return transitions
+	 */
+	static constexpr const Transition* check(const Transition* t, uint8_t n, uint8_t i){
+		return (i >= n)? t :
+				(t[i].state < NumStates && (t[i].sig & (t[i].sig - 1)) == 0 && signalIndex(t[i].sig) < NumSignals && (t[i].target < NumStates || t[i].target == Internal))?
+				check(t, n, i + 1) : (invalidTransition(), t);
+	}
+
+
+	/** Obtiene la primera transicion de (state, sig) a partir de la i-esima */
+	static constexpr uint8_t first(const Transition* t, uint8_t n, uint8_t state, uint32_t sig, uint8_t i){
+		return (i >= n)? NoTransition : (t[i].state == state && signalIndex(t[i].sig) == sig)? i : first(t, n, state, sig, i + 1);
+	}
+
+
+	/** Construye la matriz estado x senal, una celda por indice de la secuencia */
+	template<uint16_t... I>
+	static constexpr Index makeIndex(const Transition* t, uint8_t n, StateTableSeq<I...>){
+		return Index{ t, n, { first(t, n, (uint8_t)(I / NumSignals), I % NumSignals, 0)... } };
+	}
+
+
+	/** Ejecuta una transicion
+	 *  @param t Transicion
+	 *  @param msg Mensaje
+	 */
+	void fire(const Transition& t, State::Msg* msg){
+		if(t.target == Internal){
+			if(t.action){
+				(_owner->*t.action)(msg);
+			}
+			return;
+		}
+		if(_states[_current].exit){
+			(_owner->*_states[_current].exit)();
+		}
+		if(t.action){
+			(_owner->*t.action)(msg);
+		}
+		enter(t.target);
+	}
+
+
+	/** Entra en un estado
+	 *  @param state Estado
+	 */
+	void enter(uint8_t state){
+		_current = state;
+		if(_states[state].entry){
+			(_owner->*_states[state].entry)();
+		}
+	}
+};
+
+#endif /*__StateTable__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,318 @@
+/*
+ * StaticActiveModule.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	StaticActiveModule es una variante de ActiveModule resuelta en tiempo de compilacion (CRTP) para modulos de
+ *	alta carga:
+ *	  - Pila del thread, cola de mensajes, pool de mensajes y callback del manejador de mensajes se alojan dentro
+ *	    del propio objeto: la construccion no realiza ninguna reserva de memoria dinamica.
+ *	  - putMessage, la espera de mensajes y el despacho no son virtuales.
+ *	  - Las senales se despachan mediante una tabla constexpr senal -> metodo de Derived (SignalTable), que se
+ *	    resuelve en tiempo de compilacion en un array indexado por la posicion del bit de la senal
+ *	    (State::EV_RESERVED_USER << i): el despacho es un acceso directo, independiente del numero de senales.
+ *	    Las senales de la tabla que no son senales de usuario de un bit son un error de compilacion. Las senales
+ *	    no incluidas en la tabla (y los eventos EV_ENTRY/EV_EXIT) se delegan en la maquina de estados
+ *	    (Init_EventHandler de Derived).
+ *
+ *	No incluye las funcionalidades opcionales de ActiveModule (carriles, politicas de sobrecarga, metricas,
+ *	temporizadores, executor...). El thread se inicia explicitamente con start(), una vez construido Derived.
+ *
+ *	Ejemplo:
+ *		class Fast : public StaticActiveModule<Fast, 16> {
+ *		  public:
+ *			Fast(FSManager* fs) : StaticActiveModule<Fast, 16>("Fast", osPriorityHigh, fs) {}
+ *			State::StateResult Init_EventHandler(State::StateEvent* se);
+ *			State::StateResult onSample(State::Msg* msg);
+ *			static constexpr SignalEntry SignalTable[] = {
+ *				{ SampleEvt, &Fast::onSample },
+ *			};
+ *		};
+ *		constexpr Fast::SignalEntry Fast::SignalTable[];	// definicion en el .cpp (C++11)
+ *
+ *		Fast* fast = new Fast(fs);
+ *		fast->start();
+ */
+
+#ifndef __StaticActiveModule__H
+#define __StaticActiveModule__H
+
+#include "mbed.h"
+#include "StateMachine.h"
+#include "MQLib.h"
+#include "FSManager.h"
+#include "StateTable.h"
+
+/** Tamano de los datos alojables en los mensajes del pool por defecto */
+#ifndef ACTIVEMODULE_INLINE_PAYLOAD
+#define ACTIVEMODULE_INLINE_PAYLOAD		32
+#endif
+
+
+template<class Derived, uint32_t QueueDepth, uint32_t StackSize = OS_STACK_SIZE, uint16_t PayloadSize = ACTIVEMODULE_INLINE_PAYLOAD>
+class StaticActiveModule : public StateMachine {
+  public:
+
+	/** Manejador de una senal en Derived */
+	typedef State::StateResult (Derived::*SignalHandler)(State::Msg* msg);
+
+	/** Entrada de la tabla de despacho de senales */
+	struct SignalEntry {
+		uint32_t sig;							/// Senal
+		SignalHandler handler;					/// Manejador
+	};
+
+	/** Tabla de despacho por defecto (vacia). Derived la oculta declarando su propia SignalTable. */
+	static constexpr SignalEntry SignalTable[1] = { { 0, nullptr } };
+
+	/** Numero de senales de usuario (State::EV_RESERVED_USER << i) */
+	static const uint8_t NumSignals = 32 - __builtin_ctz((uint32_t)State::EV_RESERVED_USER);
+
+	/** Tabla de despacho resuelta en compilacion: manejador de cada senal de usuario (NULL: maquina de estados) */
+	struct SignalIndex {
+		SignalHandler handler[NumSignals];
+	};
+
+
+    /** Constructor. No inicia el thread (ver start).
+     *  @param name Nombre del thread
+     *  @param priority Prioridad del thread
+     *  @param fs Gestor del sistema de backup en memoria NVS
+     *  @param defdbg Flag para habilitar depuracion por defecto
+     */
+	StaticActiveModule(const char* name, osPriority priority, FSManager* fs, bool defdbg = false) :
+			_th(priority, StackSize, _stack, name),
+			_msg_cb(this, &StaticActiveModule::putMessage) {
+		_free_blocks = NULL;
+		for(uint32_t i = QueueDepth; i > 0; i--){
+			_blocks[i - 1].next = _free_blocks;
+			_free_blocks = &_blocks[i - 1];
+		}
+		_fs = fs;
+		_defdbg = defdbg;
+		_ready = false;
+		_pub_topic_base = NULL;
+		_sub_topic_base = NULL;
+		StateMachine::attachMessageHandler(&_msg_cb);
+		_stInit.setHandler(callback(static_cast<Derived*>(this), &Derived::Init_EventHandler));
+	}
+
+
+    /** Inicia el thread del modulo. Debe invocarse una vez construido completamente Derived.
+     *  @return Resultado
+     */
+	osStatus start(){
+		return _th.start(callback(this, &StaticActiveModule::task));
+	}
+
+
+    /** Postea un mensaje en la cola del modulo. ISR-safe. El mensaje pasa a ser propiedad del modulo: si no
+     *  puede encolarse, se libera (los mensajes que no son del pool, con Heap::memFree).
+     *  @param msg Mensaje a postear
+     *  @return Resultado
+     */
+	osStatus putMessage(State::Msg* msg){
+		osStatus ost = _queue.put(msg, IS_ISR()? 0 : DefaultPutTimeout);
+		if(ost != osOK){
+			Block* blk = poolBlock(msg);
+			if(blk){
+				freeBlock(blk);
+			}
+			else{
+				Heap::memFree(msg->msg);
+				Heap::memFree(msg);
+			}
+		}
+		return ost;
+	}
+
+
+    /** Crea un mensaje en el pool del modulo, copiando sus datos. Se libera automaticamente tras su despacho.
+     *  ISR-safe.
+     *  @param sig Senal del mensaje
+     *  @param data Datos a copiar (NULL: sin copia)
+     *  @param size Tamano de los datos (hasta PayloadSize)
+     *  @return Mensaje o NULL si no hay espacio
+     */
+	State::Msg* newMessage(uint32_t sig, const void* data = NULL, uint16_t size = 0){
+		if(size > PayloadSize){
+			return NULL;
+		}
+		core_util_critical_section_enter();
+		Block* blk = _free_blocks;
+		if(blk){
+			_free_blocks = blk->next;
+		}
+		core_util_critical_section_exit();
+		if(!blk){
+			return NULL;
+		}
+		blk->msg.sig = sig;
+		blk->msg.msg = (size)? blk->data : NULL;
+		if(data && size){
+			memcpy(blk->data, data, size);
+		}
+		return &blk->msg;
+	}
+
+
+    /** Asigna el nombre del topic base para las publicaciones
+     *  @param name Nombre del topic base
+     */
+	void setPublicationBase(const char* name){
+		_pub_topic_base = name;
+	}
+
+
+    /** Asigna el nombre del topic base para las suscripciones
+     *  @param name Nombre del topic base
+     */
+	void setSubscriptionBase(const char* name){
+		_sub_topic_base = name;
+	}
+
+
+    /** Chequea si el modulo ha completado su inicializacion
+     *  @return True si esta listo
+     */
+	bool ready(){
+		return _ready;
+	}
+
+  protected:
+
+    /** Tiempo de espera por defecto al postear un mensaje */
+	static const uint32_t DefaultPutTimeout = MQ::MQBroker::DefaultMutexTimeout;
+
+	const char* _pub_topic_base;				/// Nombre del topic base para las publicaciones
+	const char* _sub_topic_base;				/// Nombre del topic base para las suscripciones
+	FSManager* _fs;								/// Gestor del sistema de backup en memoria NVS
+	bool _defdbg;								/// Flag para depuracion por defecto
+	bool _ready;								/// Flag para indicar el estado del modulo a nivel de thread
+	State _stInit;								/// Estado inicial (Derived::Init_EventHandler)
+
+  private:
+
+	/** Bloque de un mensaje del pool. Los bloques se identifican por su posicion en _blocks, sin acceder a la
+	 *  memoria que precede a los mensajes que no son del pool. */
+	struct Block {
+		Block* next;							/// Siguiente bloque libre
+		State::Msg msg;							/// Mensaje
+		uint8_t data[PayloadSize? PayloadSize : 1];	/// Datos
+	};
+
+	MBED_ALIGN(8) unsigned char _stack[StackSize];
+	Thread _th;
+	Queue<State::Msg, QueueDepth> _queue;
+	Block _blocks[QueueDepth];					/// Pool de mensajes
+	Block* _free_blocks;						/// Lista de bloques libres
+	Callback<osStatus(State::Msg*)> _msg_cb;
+
+
+	/** Obtiene el bloque del pool de un mensaje, comparando unicamente su direccion
+	 *  @param msg Mensaje
+	 *  @return Bloque o NULL si el mensaje no es del pool
+	 */
+	Block* poolBlock(const State::Msg* msg){
+		uintptr_t addr = (uintptr_t)msg - offsetof(Block, msg);
+		uintptr_t first = (uintptr_t)&_blocks[0];
+		if(addr < first || addr >= (uintptr_t)&_blocks[QueueDepth] || (addr - first) % sizeof(Block) != 0){
+			return NULL;
+		}
+		return (Block*)addr;
+	}
+
+
+	/** Devuelve un bloque al pool. ISR-safe.
+	 *  @param blk Bloque
+	 */
+	void freeBlock(Block* blk){
+		core_util_critical_section_enter();
+		blk->next = _free_blocks;
+		_free_blocks = blk;
+		core_util_critical_section_exit();
+	}
+
+
+	/** Obtiene el indice de una senal por la posicion de su bit
+	 *  @param sig Senal
+	 *  @return Indice (>= NumSignals si no es una senal de usuario de un bit)
+	 */
+	static constexpr uint32_t signalIndex(uint32_t sig){
+		return (sig < (uint32_t)State::EV_RESERVED_USER || (sig & (sig - 1)) != 0)? NumSignals :
+				(uint32_t)(__builtin_ctz(sig) - __builtin_ctz((uint32_t)State::EV_RESERVED_USER));
+	}
+
+
+	/** Senal fuera de rango. No es constexpr: invocarla al resolver la tabla produce un error de compilacion */
+	static void invalidSignal() {}
+
+
+	/** Comprueba las senales de la tabla a partir de la i-esima entrada
+	 *  @return table
+	 */
+	static constexpr const SignalEntry* check(const SignalEntry* t, size_t n, size_t i){
+		return (i >= n)? t : (!t[i].handler || signalIndex(t[i].sig) < NumSignals)? check(t, n, i + 1) : (invalidSignal(), t);
+	}
+
+
+	/** Obtiene el manejador de la primera entrada de la senal de indice idx a partir de la i-esima */
+	static constexpr SignalHandler find(const SignalEntry* t, size_t n, uint32_t idx, size_t i){
+		return (i >= n)? nullptr : (t[i].handler && signalIndex(t[i].sig) == idx)? t[i].handler : find(t, n, idx, i + 1);
+	}
+
+
+	/** Construye la tabla de despacho, una entrada por indice de la secuencia */
+	template<uint16_t... I>
+	static constexpr SignalIndex makeIndex(const SignalEntry* t, size_t n, StateTableSeq<I...>){
+		return SignalIndex{ { find(t, n, I, 0)... } };
+	}
+
+
+	/** Bucle de ejecucion del thread del modulo
+	 */
+	void task(){
+		initState(&_stInit);
+		for(;;){
+			osEvent oe = _queue.get();
+			dispatch(&oe);
+		}
+	}
+
+
+	/** Despacha un evento: las senales de SignalTable se invocan directamente, el resto en la maquina de estados.
+	 *  Los mensajes del pool se liberan tras su despacho; el resto los liberan sus manejadores.
+	 *  @param oe Evento
+	 */
+	void dispatch(osEvent* oe){
+		if(oe->status != osEventMessage){
+			run(oe);
+			return;
+		}
+		// tabla resuelta al instanciar el despacho, con Derived ya completo
+		static constexpr size_t N = sizeof(Derived::SignalTable) / sizeof(SignalEntry);
+		static constexpr SignalIndex index = makeIndex(check(Derived::SignalTable, N, 0), N, typename StateTableMakeSeq<NumSignals>::type());
+		State::Msg* msg = (State::Msg*)oe->value.p;
+		// se decide antes del despacho, ya que los manejadores liberan los mensajes que no son del pool
+		Block* blk = poolBlock(msg);
+		uint32_t idx = signalIndex(msg->sig);
+		if(idx < NumSignals && index.handler[idx]){
+			(static_cast<Derived*>(this)->*index.handler[idx])(msg);
+		}
+		else{
+			run(oe);
+		}
+		if(blk){
+			freeBlock(blk);
+		}
+	}
+};
+
+template<class Derived, uint32_t QueueDepth, uint32_t StackSize, uint16_t PayloadSize>
+constexpr typename StaticActiveModule<Derived, QueueDepth, StackSize, PayloadSize>::SignalEntry
+		StaticActiveModule<Derived, QueueDepth, StackSize, PayloadSize>::SignalTable[1];
+
+#endif /*__StaticActiveModule__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,57 @@
+/*
+ * TaskHeartbeat.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "TaskHeartbeat.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+TaskHeartbeat::Entry TaskHeartbeat::_entries[TaskHeartbeat::MaxEntries];
+std::atomic<uint32_t> TaskHeartbeat::_count(0);
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+int32_t TaskHeartbeat::attach(const char* name, uint32_t millis){
+	uint32_t id = _count.load();
+	do{
+		if(id >= MaxEntries){
+			return -1;
+		}
+	}while(!_count.compare_exchange_weak(id, id + 1));
+	_entries[id].name = name;
+	_entries[id].millis = millis;
+	_entries[id].last.store(now(), std::memory_order_relaxed);
+	// cada entrada se publica por separado, de forma que check() omite las que estan a medio inicializar sin que
+	// ninguna tarea tenga que esperar a otra
+	_entries[id].valid.store(true, std::memory_order_release);
+	return id;
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t TaskHeartbeat::check(StalledCallback cb, uint32_t tolerance){
+	uint32_t stalled = 0;
+	uint32_t t = now();
+	uint32_t count = _count.load();
+	for(uint32_t i = 0; i < count; i++){
+		if(!_entries[i].valid.load(std::memory_order_acquire)){
+			continue;
+		}
+		uint32_t elapsed = t - _entries[i].last.load(std::memory_order_relaxed);
+		if(elapsed > _entries[i].millis * tolerance){
+			stalled++;
+			cb.call(_entries[i].name, elapsed);
+		}
+	}
+	return stalled;
+}
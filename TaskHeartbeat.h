@@ -0,0 +1,76 @@
+/*
+ * TaskHeartbeat.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	TaskHeartbeat es una tabla compartida y libre de bloqueos con la ultima marca de actividad de cada tarea
+ *	registrada. Cada tarea actualiza su marca (una escritura atomica) y el gestor de watchdog recorre la tabla
+ *	periodicamente con check() para detectar las tareas bloqueadas, sin necesidad de mensajes MQ.
+ */
+
+#ifndef __TaskHeartbeat__H
+#define __TaskHeartbeat__H
+
+#include "mbed.h"
+#include <atomic>
+
+
+class TaskHeartbeat {
+  public:
+
+	/** Maximo numero de tareas registrables */
+	static const uint8_t MaxEntries = 32;
+
+	/** Callback invocada por check() por cada tarea sin actividad
+	 *  @param name Nombre de la tarea
+	 *  @param elapsed Milisegundos desde su ultima marca de actividad
+	 */
+	typedef Callback<void(const char* name, uint32_t elapsed)> StalledCallback;
+
+
+    /** Registra una tarea en la tabla
+     *  @param name Nombre de la tarea (debe ser persistente)
+     *  @param millis Periodo maximo entre marcas de actividad
+     *  @return Identificador de la entrada o -1 si la tabla esta llena
+     */
+	static int32_t attach(const char* name, uint32_t millis);
+
+
+    /** Actualiza la marca de actividad de una tarea. ISR-safe.
+     *  @param id Identificador obtenido en attach
+     */
+	static void beat(int32_t id){
+		_entries[id].last.store(now(), std::memory_order_relaxed);
+	}
+
+
+    /** Recorre la tabla notificando las tareas cuya ultima marca supera 'tolerance' veces su periodo
+     *  @param cb Callback invocada por cada tarea sin actividad
+     *  @param tolerance Numero de periodos permitidos sin actividad
+     *  @return Numero de tareas sin actividad
+     */
+	static uint32_t check(StalledCallback cb, uint32_t tolerance = 2);
+
+
+    /** Obtiene la marca de tiempo utilizada en la tabla
+     *  @return Milisegundos desde el arranque
+     */
+	static uint32_t now(){ return (uint32_t)Kernel::get_ms_count(); }
+
+  private:
+
+	struct Entry {
+		const char* name;						/// Nombre de la tarea
+		uint32_t millis;						/// Periodo maximo entre marcas
+		std::atomic<uint32_t> last;				/// Ultima marca de actividad
+		std::atomic<bool> valid;				/// Entrada completamente inicializada
+	};
+
+	static Entry _entries[MaxEntries];			/// Tabla de tareas
+	static std::atomic<uint32_t> _count;		/// Entradas reservadas
+};
+
+#endif /*__TaskHeartbeat__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,107 @@
+/*
+ * TimerService.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "TimerService.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+Thread* TimerService::_th = NULL;
+Mutex TimerService::_mtx;
+Semaphore TimerService::_sem(0, 1);
+TimerWheel* TimerService::_wheels[TimerService::MaxWheels];
+uint8_t TimerService::_count = 0;
+uint32_t TimerService::_wake_tick = 0;
+bool TimerService::_sleeping = true;
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+TimerWheel* TimerService::attach(uint16_t max_timers, TimerWheel::ExpiredCallback expired){
+	_mtx.lock();
+	if(_count >= MaxWheels){
+		_mtx.unlock();
+		return NULL;
+	}
+	TimerWheel* wheel = new TimerWheel(max_timers, expired, (uint32_t)(Kernel::get_ms_count() / TickMillis));
+	MBED_ASSERT(wheel);
+	_wheels[_count++] = wheel;
+	if(!_th){
+		_th = new Thread(TIMERSERVICE_PRIORITY, TIMERSERVICE_STACK_SIZE, NULL, "TimerService");
+		MBED_ASSERT(_th);
+		_th->start(callback(&TimerService::task));
+	}
+	_mtx.unlock();
+	return wheel;
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t TimerService::start(TimerWheel* wheel, uint32_t sig, uint32_t delay, uint32_t period){
+	uint64_t now = Kernel::get_ms_count();
+	// vence en el primer tick que no sea anterior al plazo solicitado
+	uint32_t expires = (uint32_t)((now + delay + TickMillis - 1) / TickMillis);
+	uint32_t period_ticks = (period)? ((period + TickMillis - 1) / TickMillis) : 0;
+	_mtx.lock();
+	int32_t id = wheel->start(sig, expires, period_ticks);
+	// despierta el thread de servicio si el nuevo vencimiento es anterior al previsto
+	bool wake = (id >= 0 && (_sleeping || (int32_t)(expires - _wake_tick) < 0));
+	_mtx.unlock();
+	if(wake){
+		_sem.release();
+	}
+	return id;
+}
+
+
+//------------------------------------------------------------------------------------
+bool TimerService::cancel(TimerWheel* wheel, int32_t id){
+	_mtx.lock();
+	bool result = wheel->cancel(id);
+	_mtx.unlock();
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE METHODS IMPLEMENTATION --------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+void TimerService::task(){
+	for(;;){
+		_mtx.lock();
+		uint64_t now_ms = Kernel::get_ms_count();
+		uint32_t now = (uint32_t)(now_ms / TickMillis);
+		bool found = false;
+		uint32_t next = 0;
+		for(uint8_t i = 0; i < _count; i++){
+			uint32_t tick;
+			_wheels[i]->advance(now);
+			if(_wheels[i]->nextEvent(tick) && (!found || (int32_t)(tick - next) < 0)){
+				next = tick;
+				found = true;
+			}
+		}
+		_sleeping = !found;
+		_wake_tick = next;
+		_mtx.unlock();
+		// espera hasta el inicio del tick del siguiente evento, comun a todas las ruedas
+		uint32_t millis = osWaitForever;
+		if(found){
+			int32_t ticks = (int32_t)(next - now);
+			millis = (ticks > 0)? (uint32_t)(ticks * TickMillis - (now_ms % TickMillis)) : 0;
+		}
+		_sem.wait(millis);
+	}
+}
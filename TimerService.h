@@ -0,0 +1,85 @@
+/*
+ * TimerService.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	TimerService es la fuente de ticks compartida por las ruedas de temporizacion (TimerWheel) de todos los modulos.
+ *	Un unico thread, creado en el primer uso, duerme hasta el siguiente evento de todas las ruedas registradas y las
+ *	avanza, de forma que los vencimientos de distintos modulos que coinciden en el mismo tick se atienden en un
+ *	unico despertar. Los ticks son multiplos de TIMERSERVICE_TICK_MS sobre el reloj del kernel.
+ *
+ *	El acceso a las ruedas se protege con un mutex, por lo que start y cancel no pueden invocarse desde una ISR.
+ */
+
+#ifndef __TimerService__H
+#define __TimerService__H
+
+#include "mbed.h"
+#include "TimerWheel.h"
+
+/** Resolucion en milisegundos de los temporizadores */
+#if !defined(TIMERSERVICE_TICK_MS)
+#define TIMERSERVICE_TICK_MS	10
+#endif
+
+/** Prioridad y tamano de pila del thread de servicio */
+#if !defined(TIMERSERVICE_PRIORITY)
+#define TIMERSERVICE_PRIORITY	osPriorityAboveNormal
+#endif
+#if !defined(TIMERSERVICE_STACK_SIZE)
+#define TIMERSERVICE_STACK_SIZE	OS_STACK_SIZE
+#endif
+
+
+class TimerService {
+  public:
+
+	/** Maximo numero de ruedas registrables */
+	static const uint8_t MaxWheels = 32;
+
+	/** Resolucion de los temporizadores */
+	static const uint32_t TickMillis = TIMERSERVICE_TICK_MS;
+
+
+    /** Crea una rueda de temporizacion y la registra en el servicio
+     *  @param max_timers Maximo numero de temporizadores armados simultaneamente
+     *  @param expired Callback de vencimiento, invocada desde el thread de servicio (no debe bloquear)
+     *  @return Rueda creada o NULL si no se ha podido registrar
+     */
+	static TimerWheel* attach(uint16_t max_timers, TimerWheel::ExpiredCallback expired);
+
+
+    /** Arma un temporizador en una rueda
+     *  @param wheel Rueda
+     *  @param sig Senal asociada
+     *  @param delay Milisegundos hasta el primer vencimiento (se redondea al siguiente tick)
+     *  @param period Periodo en milisegundos (0: de un solo disparo)
+     *  @return Identificador del temporizador o -1 si no quedan temporizadores libres
+     */
+	static int32_t start(TimerWheel* wheel, uint32_t sig, uint32_t delay, uint32_t period);
+
+
+    /** Cancela un temporizador
+     *  @param wheel Rueda
+     *  @param id Identificador obtenido en start
+     *  @return True: cancelado, False: ya vencido, cancelado o identificador invalido
+     */
+	static bool cancel(TimerWheel* wheel, int32_t id);
+
+  private:
+
+	static Thread* _th;							/// Thread de servicio (creado en el primer attach)
+	static Mutex _mtx;							/// Acceso exclusivo a las ruedas
+	static Semaphore _sem;						/// Despertar anticipado del thread de servicio
+	static TimerWheel* _wheels[MaxWheels];		/// Ruedas registradas
+	static uint8_t _count;						/// Numero de ruedas registradas
+	static uint32_t _wake_tick;					/// Tick en el que despertara el thread de servicio
+	static bool _sleeping;						/// Thread de servicio esperando sin plazo
+
+	static void task();
+};
+
+#endif /*__TimerService__H */
+
+/**** END OF FILE ****/
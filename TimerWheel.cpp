@@ -0,0 +1,210 @@
+/*
+ * TimerWheel.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "TimerWheel.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+TimerWheel::TimerWheel(uint16_t max_timers, ExpiredCallback expired, uint32_t now){
+	MBED_ASSERT(SlotBits * Levels < 32);
+	_max_timers = max_timers;
+	_expired = expired;
+	_now = now;
+	_timers = new Timer[max_timers]();
+	MBED_ASSERT(_timers);
+	_free = NULL;
+	for(int i = max_timers - 1; i >= 0; i--){
+		_timers[i].next = _free;
+		_free = &_timers[i];
+	}
+	memset(_slots, 0, sizeof(_slots));
+	memset(_bitmap, 0, sizeof(_bitmap));
+}
+
+
+//------------------------------------------------------------------------------------
+TimerWheel::~TimerWheel(){
+	delete[] _timers;
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t TimerWheel::start(uint32_t sig, uint32_t expires, uint32_t period){
+	Timer* t = _free;
+	if(!t){
+		return -1;
+	}
+	_free = t->next;
+	t->sig = sig;
+	t->period = period;
+	// nunca vence en el tick en curso, que ya ha sido procesado
+	t->expires = ((int32_t)(expires - _now) > 0)? expires : (_now + 1);
+	t->armed = true;
+	insert(t);
+	return (int32_t)(((uint32_t)t->gen << 16) | (uint32_t)(t - _timers));
+}
+
+
+//------------------------------------------------------------------------------------
+bool TimerWheel::cancel(int32_t id){
+	uint32_t idx = (uint32_t)id & 0xFFFF;
+	if(id < 0 || idx >= _max_timers){
+		return false;
+	}
+	Timer* t = &_timers[idx];
+	if(!t->armed || t->gen != ((uint32_t)id >> 16)){
+		return false;
+	}
+	unlink(t);
+	release(t);
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------
+void TimerWheel::advance(uint32_t now){
+	uint32_t tick = 0;
+	while(nextEvent(tick) && (int32_t)(tick - now) <= 0){
+		_now = tick;
+		// reubica las ranuras de los niveles superiores alcanzadas en este tick
+		for(int l = Levels - 1; l > 0; l--){
+			if((tick & ((1UL << (SlotBits * l)) - 1)) == 0){
+				Timer* t = take(l, (tick >> (SlotBits * l)) & (Slots - 1));
+				while(t){
+					Timer* next = t->next;
+					if((int32_t)(t->expires - tick) <= 0){
+						expire(t);
+					}
+					else{
+						insert(t);
+					}
+					t = next;
+				}
+			}
+		}
+		// procesa los vencimientos del nivel inferior
+		Timer* t = take(0, tick & (Slots - 1));
+		while(t){
+			Timer* next = t->next;
+			expire(t);
+			t = next;
+		}
+	}
+	if((int32_t)(now - _now) > 0){
+		_now = now;
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+bool TimerWheel::nextEvent(uint32_t& tick){
+	bool found = false;
+	for(uint8_t l = 0; l < Levels; l++){
+		if(!_bitmap[l]){
+			continue;
+		}
+		uint32_t base = _now >> (SlotBits * l);
+		for(uint32_t j = 1; j <= Slots; j++){
+			if(_bitmap[l] & (1UL << ((base + j) & (Slots - 1)))){
+				uint32_t t = (base + j) << (SlotBits * l);
+				if(!found || (int32_t)(t - tick) < 0){
+					tick = t;
+					found = true;
+				}
+				break;
+			}
+		}
+	}
+	return found;
+}
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE METHODS IMPLEMENTATION --------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+void TimerWheel::insert(Timer* t){
+	uint32_t delta = t->expires - _now;
+	// los plazos fuera de alcance se ubican en la ultima ranura alcanzable y se reubican al descender
+	if(delta >= (1UL << (SlotBits * Levels))){
+		delta = (1UL << (SlotBits * Levels)) - 1;
+	}
+	uint8_t level = 0;
+	while(level < Levels - 1 && delta >= (1UL << (SlotBits * (level + 1)))){
+		level++;
+	}
+	uint8_t slot = ((_now + delta) >> (SlotBits * level)) & (Slots - 1);
+	t->level = level;
+	t->slot = slot;
+	t->prev = NULL;
+	t->next = _slots[level][slot];
+	if(t->next){
+		t->next->prev = t;
+	}
+	_slots[level][slot] = t;
+	_bitmap[level] |= (1UL << slot);
+}
+
+
+//------------------------------------------------------------------------------------
+void TimerWheel::unlink(Timer* t){
+	if(t->prev){
+		t->prev->next = t->next;
+	}
+	else{
+		_slots[t->level][t->slot] = t->next;
+		if(!t->next){
+			_bitmap[t->level] &= ~(1UL << t->slot);
+		}
+	}
+	if(t->next){
+		t->next->prev = t->prev;
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+void TimerWheel::release(Timer* t){
+	t->armed = false;
+	t->gen = (t->gen + 1) & 0x7FFF;
+	t->next = _free;
+	_free = t;
+}
+
+
+//------------------------------------------------------------------------------------
+void TimerWheel::expire(Timer* t){
+	uint32_t sig = t->sig;
+	if(t->period){
+		// rearma sin deriva respecto del vencimiento anterior, descartando los periodos perdidos
+		t->expires += t->period;
+		if((int32_t)(t->expires - _now) <= 0){
+			t->expires = _now + t->period;
+		}
+		insert(t);
+	}
+	else{
+		release(t);
+	}
+	_expired(sig);
+}
+
+
+//------------------------------------------------------------------------------------
+TimerWheel::Timer* TimerWheel::take(uint8_t level, uint8_t slot){
+	Timer* t = _slots[level][slot];
+	_slots[level][slot] = NULL;
+	_bitmap[level] &= ~(1UL << slot);
+	return t;
+}
@@ -0,0 +1,118 @@
+/*
+ * TimerWheel.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	TimerWheel es una rueda de temporizacion jerarquica de Levels niveles de 32 ranuras cada uno, con armado y
+ *	cancelacion en O(1). Los temporizadores se almacenan en un array de tamano fijo reservado en la construccion y
+ *	las ranuras ocupadas de cada nivel se marcan en un bitmap, de forma que el siguiente evento se localiza sin
+ *	recorrer la rueda tick a tick. Los temporizadores con plazo superior al alcance de la rueda se reubican al
+ *	descender de nivel. Al vencer un temporizador se invoca la callback de vencimiento con su senal asociada.
+ *
+ *	No es thread-safe: el acceso concurrente debe protegerse externamente (ver TimerService).
+ */
+
+#ifndef __TimerWheel__H
+#define __TimerWheel__H
+
+#include "mbed.h"
+
+/** Numero de niveles de la rueda (alcance de 32^TIMERWHEEL_LEVELS ticks) */
+#if !defined(TIMERWHEEL_LEVELS)
+#define TIMERWHEEL_LEVELS	4
+#endif
+
+
+class TimerWheel {
+  public:
+
+	/** Numero de bits de ranura por nivel */
+	static const uint8_t SlotBits = 5;
+
+	/** Numero de ranuras por nivel */
+	static const uint8_t Slots = (1 << SlotBits);
+
+	/** Numero de niveles */
+	static const uint8_t Levels = TIMERWHEEL_LEVELS;
+
+	/** Callback invocada al vencer un temporizador
+	 *  @param sig Senal asociada al temporizador
+	 */
+	typedef Callback<void(uint32_t sig)> ExpiredCallback;
+
+
+    /** Constructor
+     *  @param max_timers Maximo numero de temporizadores armados simultaneamente
+     *  @param expired Callback de vencimiento
+     *  @param now Tick actual
+     */
+	TimerWheel(uint16_t max_timers, ExpiredCallback expired, uint32_t now);
+
+
+    /** Destructor
+     */
+	~TimerWheel();
+
+
+    /** Arma un temporizador
+     *  @param sig Senal asociada
+     *  @param expires Tick absoluto de vencimiento
+     *  @param period Periodo en ticks (0: de un solo disparo)
+     *  @return Identificador del temporizador o -1 si no quedan temporizadores libres
+     */
+	int32_t start(uint32_t sig, uint32_t expires, uint32_t period);
+
+
+    /** Cancela un temporizador armado
+     *  @param id Identificador obtenido en start
+     *  @return True: cancelado, False: ya vencido, cancelado o identificador invalido
+     */
+	bool cancel(int32_t id);
+
+
+    /** Avanza la rueda hasta el tick indicado, invocando la callback de vencimiento de los temporizadores vencidos
+     *  y rearmando los periodicos
+     *  @param now Tick actual
+     */
+	void advance(uint32_t now);
+
+
+    /** Obtiene el tick del siguiente evento de la rueda (vencimiento o reubicacion de un nivel superior)
+     *  @param tick Recibe el tick del siguiente evento
+     *  @return True: hay temporizadores armados, False: rueda vacia
+     */
+	bool nextEvent(uint32_t& tick);
+
+  private:
+
+	struct Timer {
+		Timer* next;							/// Siguiente en la ranura o en la lista libre
+		Timer* prev;							/// Anterior en la ranura
+		uint32_t expires;						/// Tick absoluto de vencimiento
+		uint32_t period;						/// Periodo en ticks (0: un solo disparo)
+		uint32_t sig;							/// Senal asociada
+		uint16_t gen;							/// Generacion (invalida identificadores obsoletos)
+		uint8_t level;							/// Nivel en el que esta enlazado
+		uint8_t slot;							/// Ranura en la que esta enlazado
+		bool armed;								/// Temporizador armado
+	};
+
+	Timer* _timers;								/// Temporizadores
+	Timer* _free;								/// Lista de temporizadores libres
+	uint16_t _max_timers;
+	Timer* _slots[Levels][Slots];				/// Listas de cada ranura
+	uint32_t _bitmap[Levels];					/// Ranuras ocupadas de cada nivel
+	uint32_t _now;								/// Tick hasta el que se ha avanzado la rueda
+	ExpiredCallback _expired;
+
+	void insert(Timer* t);
+	void unlink(Timer* t);
+	void release(Timer* t);
+	void expire(Timer* t);
+	Timer* take(uint8_t level, uint8_t slot);
+};
+
+#endif /*__TimerWheel__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,126 @@
+/*
+ * TopicMap.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "TopicMap.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+TopicMap::TopicMap(uint16_t max_topics){
+	_max_topics = max_topics;
+	_count = 0;
+	_num_wildcards = 0;
+	_table_size = 4;
+	while(_table_size < 2 * max_topics){
+		_table_size <<= 1;
+	}
+	_entries = new Entry[max_topics]();
+	MBED_ASSERT(_entries);
+	_table = new int16_t[_table_size];
+	MBED_ASSERT(_table);
+	_wildcards = new int16_t[max_topics];
+	MBED_ASSERT(_wildcards);
+	for(uint16_t i = 0; i < _table_size; i++){
+		_table[i] = EmptySlot;
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+TopicMap::~TopicMap(){
+	delete[] _entries;
+	delete[] _table;
+	delete[] _wildcards;
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t TopicMap::add(const char* token, MQ::SubscribeCallback handler){
+	if(_count >= _max_topics){
+		return -1;
+	}
+	size_t len;
+	const char* tk = normalize(token, &len);
+	Entry& e = _entries[_count];
+	e.reg = token;
+	e.token = tk;
+	e.len = len;
+	e.hash = hash(tk, len);
+	e.wildcard = (strpbrk(tk, "+#") != NULL);
+	e.handler = handler;
+	if(!e.wildcard){
+		uint16_t i = e.hash & (_table_size - 1);
+		while(_table[i] != EmptySlot){
+			const Entry& o = _entries[_table[i]];
+			if(o.hash == e.hash && o.len == len && strncmp(o.token, tk, len) == 0){
+				return -1;
+			}
+			i = (i + 1) & (_table_size - 1);
+		}
+		_table[i] = _count;
+	}
+	else{
+		_wildcards[_num_wildcards++] = _count;
+	}
+	return _count++;
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t TopicMap::find(const char* topic, const char* base) const {
+	// busqueda directa sobre la parte relativa al topic base
+	size_t blen = (base)? strlen(base) : 0;
+	if(blen && strncmp(topic, base, blen) == 0){
+		size_t len;
+		const char* tk = normalize(&topic[blen], &len);
+		uint32_t h = hash(tk, len);
+		uint16_t i = h & (_table_size - 1);
+		while(_table[i] != EmptySlot){
+			const Entry& e = _entries[_table[i]];
+			if(e.hash == h && e.len == len && strncmp(e.token, tk, len) == 0){
+				return _table[i];
+			}
+			i = (i + 1) & (_table_size - 1);
+		}
+	}
+	// tokens con comodines, con la semantica de isTopicToken sobre el token tal como se registro
+	for(uint16_t i = 0; i < _num_wildcards; i++){
+		if(MQ::MQClient::isTopicToken(topic, _entries[_wildcards[i]].reg)){
+			return _wildcards[i];
+		}
+	}
+	return -1;
+}
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE METHODS IMPLEMENTATION --------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+uint32_t TopicMap::hash(const char* str, size_t len){
+	uint32_t h = 2166136261u;
+	for(size_t i = 0; i < len; i++){
+		h = (h ^ (uint8_t)str[i]) * 16777619u;
+	}
+	return h;
+}
+
+
+//------------------------------------------------------------------------------------
+const char* TopicMap::normalize(const char* token, size_t* len){
+	while(*token == '/'){
+		token++;
+	}
+	*len = strlen(token);
+	return token;
+}
@@ -0,0 +1,94 @@
+/*
+ * TopicMap.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	TopicMap asocia los tokens de los topics suscritos a identificadores enteros y a sus manejadores. Los tokens
+ *	literales se resuelven mediante una tabla hash (FNV-1a, direccionamiento abierto), de forma que cada mensaje
+ *	recibido se despacha con un unico hash del topic en lugar de una cadena de comparaciones.
+ *
+ *	Los tokens con comodines '+' '#' no entran en la tabla: se guardan aparte en orden de registro y, si la
+ *	busqueda en la tabla no tiene exito, solo esos tokens se comprueban con MQClient::isTopicToken. Un topic no
+ *	registrado cuesta asi un hash mas el recorrido de los tokens con comodines, independientemente del numero de
+ *	tokens literales. Un token literal solo se asocia a los topics cuya parte relativa al topic base coincide
+ *	con el (no a los topics que simplemente lo contienen, como en una cadena de comparaciones isTopicToken).
+ */
+
+#ifndef __TopicMap__H
+#define __TopicMap__H
+
+#include "mbed.h"
+#include "MQLib.h"
+
+
+class TopicMap {
+  public:
+
+    /** Constructor
+     *  @param max_topics Numero maximo de tokens registrables
+     */
+	TopicMap(uint16_t max_topics);
+
+
+    /** Destructor
+     */
+	~TopicMap();
+
+
+    /** Registra un token y su manejador
+     *  @param token Token relativo al topic base de suscripcion (ej. "/which/event"). Debe ser persistente.
+     *  @param handler Manejador asociado
+     *  @return Identificador asignado (>= 0) o -1 si no hay espacio o ya existe
+     */
+	int32_t add(const char* token, MQ::SubscribeCallback handler);
+
+
+    /** Busca el identificador asociado a un topic recibido
+     *  @param topic Topic completo recibido
+     *  @param base Topic base de suscripcion (puede ser NULL)
+     *  @return Identificador o -1 si no se encuentra
+     */
+	int32_t find(const char* topic, const char* base) const;
+
+
+    /** Obtiene el manejador asociado a un identificador
+     *  @param id Identificador
+     *  @return Manejador
+     */
+	MQ::SubscribeCallback& handler(int32_t id) { return _entries[id].handler; }
+
+
+    /** Numero de tokens registrados
+     *  @return Numero de tokens
+     */
+	uint16_t count() const { return _count; }
+
+  private:
+
+	struct Entry {
+		const char* reg;						/// Token tal como se registro (comodines, busqueda con isTopicToken)
+		const char* token;						/// Token normalizado (sin '/' inicial)
+		uint16_t len;							/// Longitud del token
+		uint32_t hash;							/// Hash del token
+		bool wildcard;							/// Contiene comodines
+		MQ::SubscribeCallback handler;			/// Manejador
+	};
+
+	static const int16_t EmptySlot = -1;
+
+	Entry* _entries;							/// Tokens registrados (indexados por id)
+	int16_t* _table;							/// Tabla hash de ids
+	int16_t* _wildcards;						/// Ids de los tokens con comodines, en orden de registro
+	uint16_t _num_wildcards;
+	uint16_t _max_topics;
+	uint16_t _table_size;						/// Potencia de 2, al menos el doble de _max_topics
+	uint16_t _count;
+
+	static uint32_t hash(const char* str, size_t len);
+	static const char* normalize(const char* token, size_t* len);
+};
+
+#endif /*__TopicMap__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,159 @@
+/*
+ * TraceRecorder.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "TraceRecorder.h"
+#include "ActiveModule.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+TraceRecorder::TraceRecorder(const char* name, uint32_t size) : _wr(0), _enabled(true) {
+	MBED_ASSERT(size >= 2 && (size & (size - 1)) == 0);
+	_size = size;
+	_records = new Record[size]();
+	MBED_ASSERT(_records);
+	strncpy(_name, name, sizeof(_name) - 1);
+	_name[sizeof(_name) - 1] = 0;
+}
+
+
+//------------------------------------------------------------------------------------
+TraceRecorder::~TraceRecorder(){
+	delete[] _records;
+}
+
+
+//------------------------------------------------------------------------------------
+void TraceRecorder::record(RecordKind kind, uint32_t sig, const void* data, uint16_t size, uint32_t duration, uint8_t state){
+	if(!_enabled.load(std::memory_order_relaxed)){
+		return;
+	}
+	uint32_t pos = _wr.fetch_add(1, std::memory_order_relaxed);
+	Record& r = _records[pos & (_size - 1)];
+	// invalida el registro mientras se escribe, de forma que dump() lo descarte
+	r.seq = 0;
+	std::atomic_thread_fence(std::memory_order_release);
+	r.ts = us_ticker_read();
+	r.sig = sig;
+	r.duration = duration;
+	r.kind = kind;
+	r.state = state;
+	r.size = (data)? size : 0;
+	r.hash = (data && size)? hash(data, size) : 0;
+	uint16_t n = (r.size < TRACERECORDER_PAYLOAD)? r.size : TRACERECORDER_PAYLOAD;
+	if(n){
+		memcpy(r.data, data, n);
+	}
+	memset(&r.data[n], 0, TRACERECORDER_PAYLOAD - n);
+	std::atomic_thread_fence(std::memory_order_release);
+	r.seq = pos + 1;
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t TraceRecorder::dump(FILE* f){
+	uint32_t wr = _wr.load(std::memory_order_acquire);
+	uint32_t count = (wr < _size)? wr : _size;
+	TraceFileHeader hdr;
+	memset(&hdr, 0, sizeof(TraceFileHeader));
+	hdr.magic = FileMagic;
+	hdr.version = FileVersion;
+	hdr.record_size = sizeof(Record);
+	hdr.payload_size = TRACERECORDER_PAYLOAD;
+	hdr.count = count;
+	hdr.lost = wr - count;
+	strcpy(hdr.name, _name);
+	if(fwrite(&hdr, sizeof(TraceFileHeader), 1, f) != 1){
+		return 0;
+	}
+	uint32_t written = 0;
+	for(uint32_t pos = wr - count; pos != wr; pos++){
+		Record r = _records[pos & (_size - 1)];
+		std::atomic_thread_fence(std::memory_order_acquire);
+		// los registros sobrescritos o en escritura durante el volcado se marcan como no validos (seq = 0)
+		if(r.seq != pos + 1 || _records[pos & (_size - 1)].seq != r.seq){
+			r.seq = 0;
+		}
+		if(fwrite(&r, sizeof(Record), 1, f) != 1){
+			break;
+		}
+		written++;
+	}
+	return written;
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t TraceRecorder::hash(const void* data, uint16_t size){
+	uint32_t h = 2166136261UL;
+	const uint8_t* p = (const uint8_t*)data;
+	for(uint16_t i = 0; i < size; i++){
+		h = (h ^ p[i]) * 16777619UL;
+	}
+	return h;
+}
+
+
+//------------------------------------------------------------------------------------
+bool TraceReplay::replay(FILE* f, ActiveModule* module, bool realtime, Stats& stats){
+	memset(&stats, 0, sizeof(Stats));
+	TraceRecorder::TraceFileHeader hdr;
+	if(fread(&hdr, sizeof(hdr), 1, f) != 1 || hdr.magic != TraceRecorder::FileMagic ||
+	   hdr.version != TraceRecorder::FileVersion || hdr.record_size != sizeof(TraceRecorder::Record)){
+		return false;
+	}
+	uint32_t t0 = us_ticker_read();
+	uint32_t first_ts = 0;
+	bool first = true;
+	TraceRecorder::Record r;
+	for(uint32_t i = 0; i < hdr.count && fread(&r, sizeof(r), 1, f) == 1; i++){
+		if(r.seq == 0 || r.kind != TraceRecorder::RecPut){
+			continue;
+		}
+		if(first){
+			first_ts = r.ts;
+			first = false;
+		}
+		// respeta el instante original relativo al primer mensaje
+		if(realtime){
+			uint32_t due = r.ts - first_ts;
+			uint32_t now = us_ticker_read() - t0;
+			if((int32_t)(due - now) > 1000){
+				Thread::wait((due - now) / 1000);
+			}
+		}
+		State::Msg* msg = module->newMessage(r.sig, r.size);
+		for(uint32_t n = 0; !msg && n < AllocWaitMillis; n++){
+			Thread::wait(1);
+			msg = module->newMessage(r.sig, r.size);
+		}
+		if(!msg){
+			stats.failed++;
+			continue;
+		}
+		if(r.size){
+			uint16_t n = (r.size < TRACERECORDER_PAYLOAD)? r.size : TRACERECORDER_PAYLOAD;
+			memcpy(msg->msg, r.data, n);
+			if(n < r.size){
+				memset((uint8_t*)msg->msg + n, 0, r.size - n);
+				stats.truncated++;
+			}
+		}
+		if(module->putMessage(msg, r.state) == osOK){
+			stats.posted++;
+		}
+		else{
+			stats.failed++;
+		}
+	}
+	stats.elapsed_us = us_ticker_read() - t0;
+	return true;
+}
@@ -0,0 +1,158 @@
+/*
+ * TraceRecorder.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	TraceRecorder es un registro binario de eventos de un modulo sobre un buffer circular libre de bloqueos. Cada
+ *	registro ocupa un tamano fijo e incluye marca de tiempo, senal, hash FNV-1a y primeros bytes de los datos,
+ *	duracion del manejador y estado resultante. Cuando el buffer se llena se sobrescriben los registros mas
+ *	antiguos, de forma que siempre se dispone de la historia mas reciente.
+ *
+ *	Los productores (putMessage desde cualquier thread o ISR) reservan su posicion con un incremento atomico y
+ *	publican el registro con su numero de secuencia; dump() descarta los registros que se estan sobrescribiendo.
+ *
+ *	El volcado (dump) genera un fichero binario con una cabecera TraceFileHeader seguida de los registros, del mas
+ *	antiguo al mas reciente, decodificable con tools/trace_decode.py y reproducible con TraceReplay o con la
+ *	herramienta de host tools/trace_replay.
+ */
+
+#ifndef __TraceRecorder__H
+#define __TraceRecorder__H
+
+#include "mbed.h"
+#include <atomic>
+#include <stdio.h>
+
+/** Numero de bytes de datos capturados en cada registro */
+#ifndef TRACERECORDER_PAYLOAD
+#define TRACERECORDER_PAYLOAD	16
+#endif
+
+
+class TraceRecorder {
+  public:
+
+	/** Tipos de registro */
+	enum RecordKind{
+		RecPut = 1,								/// Mensaje encolado
+		RecDispatch,							/// Mensaje despachado
+		RecReject,								/// Mensaje rechazado por la cola
+	};
+
+	/** Registro binario */
+	struct Record {
+		uint32_t seq;							/// Numero de secuencia + 1 (0: registro no publicado)
+		uint32_t ts;							/// Marca de tiempo (us)
+		uint32_t sig;							/// Senal
+		uint32_t hash;							/// Hash FNV-1a de los datos completos
+		uint32_t duration;						/// Duracion del manejador (us, RecDispatch)
+		uint16_t size;							/// Tamano de los datos completos
+		uint8_t kind;							/// RecordKind
+		uint8_t state;							/// Estado resultante (RecDispatch) o carril (RecPut)
+		uint8_t data[TRACERECORDER_PAYLOAD];	/// Primeros bytes de los datos
+	};
+
+	/** Cabecera del fichero de volcado */
+	struct TraceFileHeader {
+		uint32_t magic;							/// FileMagic
+		uint16_t version;						/// FileVersion
+		uint16_t record_size;					/// sizeof(Record)
+		uint16_t payload_size;					/// TRACERECORDER_PAYLOAD
+		uint16_t reserved;
+		uint32_t count;							/// Numero de registros volcados
+		uint32_t lost;							/// Registros sobrescritos antes del volcado
+		char name[16];							/// Nombre del modulo
+	};
+
+	static const uint32_t FileMagic = 0x52544D41;	/// "AMTR"
+	static const uint16_t FileVersion = 1;
+
+
+    /** Constructor
+     *  @param name Nombre del modulo (se copia en el volcado)
+     *  @param size Numero de registros del buffer (potencia de 2)
+     */
+	TraceRecorder(const char* name, uint32_t size);
+
+
+    /** Destructor
+     */
+	~TraceRecorder();
+
+
+    /** Anade un registro. ISR-safe, libre de bloqueos.
+     *  @param kind Tipo de registro
+     *  @param sig Senal
+     *  @param data Datos (NULL: sin datos)
+     *  @param size Tamano de los datos
+     *  @param duration Duracion del manejador
+     *  @param state Estado resultante o carril
+     */
+	void record(RecordKind kind, uint32_t sig, const void* data, uint16_t size, uint32_t duration = 0, uint8_t state = 0);
+
+
+    /** Habilita o deshabilita el registro (p.ej. durante el volcado)
+     *  @param enabled Estado
+     */
+	void enable(bool enabled){
+		_enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+
+    /** Vuelca los registros disponibles, del mas antiguo al mas reciente
+     *  @param f Fichero de salida
+     *  @return Numero de registros volcados
+     */
+	uint32_t dump(FILE* f);
+
+
+    /** Calcula el hash FNV-1a de unos datos
+     *  @param data Datos
+     *  @param size Tamano
+     *  @return Hash
+     */
+	static uint32_t hash(const void* data, uint16_t size);
+
+  private:
+
+	Record* _records;
+	uint32_t _size;
+	std::atomic<uint32_t> _wr;					/// Numero de registros reservados
+	std::atomic<bool> _enabled;
+	char _name[16];
+};
+
+
+class ActiveModule;
+
+/** Reproduce en un modulo los mensajes encolados de un volcado de TraceRecorder */
+class TraceReplay {
+  public:
+
+	/** Estadisticas de la reproduccion */
+	struct Stats {
+		uint32_t posted;						/// Mensajes posteados
+		uint32_t failed;						/// Mensajes no posteados (sin memoria tras AllocWaitMillis o cola llena)
+		uint32_t truncated;						/// Mensajes con datos no capturados completamente (rellenos a 0)
+		uint32_t elapsed_us;					/// Duracion de la reproduccion
+	};
+
+	/** Espera maxima por bloques libres del modulo antes de descartar un mensaje (el productor puede adelantarse
+	 *  al modulo, sobre todo a maxima velocidad) */
+	static const uint32_t AllocWaitMillis = 100;
+
+
+    /** Reproduce los registros RecPut de un volcado
+     *  @param f Fichero de volcado
+     *  @param module Modulo destino
+     *  @param realtime True: respeta los intervalos originales, False: a maxima velocidad
+     *  @param stats Recibe las estadisticas de la reproduccion
+     *  @return True: exito, False: fichero invalido
+     */
+	static bool replay(FILE* f, ActiveModule* module, bool realtime, Stats& stats);
+};
+
+#endif /*__TraceRecorder__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,134 @@
+/*
+ * BenchModule.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Utilidades comunes de los benchmarks de host: modulo minimo que mide la latencia encolado-despacho de la
+ *	senal PingEvt (instante de envio en los datos del mensaje), percentiles y formato de los resultados.
+ */
+
+#ifndef __BenchModule__H
+#define __BenchModule__H
+
+#include "mbed.h"
+#include "ActiveModule.h"
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+
+class BenchModule : public ActiveModule {
+  public:
+
+	/** Senal de medida: los datos son el instante de envio (us_ticker_read) */
+	static const uint32_t PingEvt = State::EV_RESERVED_USER;
+
+	/** Constructor con thread propio */
+	BenchModule(const char* name, uint32_t stack_size = OS_STACK_SIZE) : ActiveModule(name, osPriorityNormal, stack_size), _received(0) {
+		setup();
+	}
+
+	/** Constructor sobre un executor */
+	BenchModule(const char* name, ActiveExecutor* executor) : ActiveModule(name, executor), _received(0) {
+		setup();
+	}
+
+	/** Envia un PingEvt con el instante actual */
+	osStatus ping(uint8_t lane = LaneNormal){
+		uint32_t now = us_ticker_read();
+		State::Msg* msg = newMessage(PingEvt, &now, sizeof(now));
+		return (msg)? putMessage(msg, lane) : osErrorNoMemory;
+	}
+
+	/** Reinicia las muestras de latencia, reservando espacio para 'samples' */
+	void reset(size_t samples){
+		_lat.clear();
+		_lat.reserve(samples);
+		_received = 0;
+	}
+
+	uint32_t received() { return _received; }
+	std::vector<uint32_t>& latencies() { return _lat; }
+
+	/** Espera a que el modulo complete su estado inicial */
+	void waitStarted(){
+		while(!isStarted()){
+			Thread::wait(1);
+		}
+	}
+
+	using ActiveModule::setMailboxType;
+	using ActiveModule::setLaneDepth;
+	using ActiveModule::newMessage;
+
+  protected:
+	std::atomic<uint32_t> _received;
+	std::vector<uint32_t> _lat;
+
+	void setup(){
+		_publicationCb = callback(this, &BenchModule::publicationCb);
+		_subscriptionCb = callback(this, &BenchModule::subscriptionCb);
+		// pool propio con bloques para la cola completa, el mensaje en despacho y el que se esta posteando
+		static const MsgPool::SizeClass pool_classes[] = { {MsgBlockSize, DefaultMaxQueueMessages + 16} };
+		setMsgPool(new MsgPool(pool_classes, 1));
+	}
+
+	virtual State::StateResult Init_EventHandler(State::StateEvent* se){
+		if(se->evt == (State::EventType)PingEvt){
+			uint32_t sent = *getMsgData<uint32_t>((State::Msg*)se->oe->value.p);
+			if(_lat.size() < _lat.capacity()){
+				_lat.push_back(us_ticker_read() - sent);
+			}
+			_received++;
+			return State::HANDLED;
+		}
+		return (se->evt == State::EV_ENTRY)? State::HANDLED : State::IGNORED;
+	}
+
+	virtual void subscriptionCb(const char* /*topic*/, void* /*msg*/, uint16_t /*msg_len*/) {}
+	virtual void publicationCb(const char* /*topic*/, int32_t /*result*/) {}
+	virtual bool checkIntegrity() { return true; }
+	virtual void setDefaultConfig() {}
+	virtual void restoreConfig() {}
+	virtual void saveConfig() {}
+};
+
+
+/** Percentil de un conjunto de muestras (se ordenan) */
+static inline uint32_t benchPercentile(std::vector<uint32_t>& v, double p){
+	if(v.empty()){
+		return 0;
+	}
+	std::sort(v.begin(), v.end());
+	size_t i = (size_t)(p * (v.size() - 1) + 0.5);
+	return v[i];
+}
+
+
+/** Instante actual en microsegundos (64 bits) */
+static inline uint64_t benchNow(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+
+/** Imprime una linea de resultados de latencia: p50/p90/p99/max en us */
+static inline void benchPrintLatency(const char* label, std::vector<uint32_t>& lat, double events_per_sec){
+	uint32_t p50 = benchPercentile(lat, 0.50);
+	uint32_t p90 = benchPercentile(lat, 0.90);
+	uint32_t p99 = benchPercentile(lat, 0.99);
+	uint32_t max = (lat.empty())? 0 : lat.back();
+	printf("%-28s %8u %8u %8u %8u %12.0f\n", label, p50, p90, p99, max, events_per_sec);
+}
+
+
+/** Imprime la cabecera de benchPrintLatency */
+static inline void benchPrintHeader(const char* title){
+	printf("\n== %s\n%-28s %8s %8s %8s %8s %12s\n", title, "", "p50(us)", "p90(us)", "p99(us)", "max(us)", "events/s");
+}
+
+#endif /*__BenchModule__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,156 @@
+/*
+ * bench_call.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Llamadas asincronas entre modulos (call/reply), sin vencimiento y con vencimiento (temporizador armado en cada
+ *	llamada y cancelado con la respuesta):
+ *	  - Latencia call -> respuesta recibida en el llamante, con una unica llamada pendiente.
+ *	  - Llamadas por segundo con hasta Window llamadas pendientes.
+ *	  - Vencimiento: retraso de la senal de vencimiento respecto al plazo, con un destino que no responde.
+ *	En todas las medidas se contabilizan los vencimientos recibidos, que solo deben aparecer en la ultima.
+ *
+ *	Uso: bench_call [llamadas por medida]
+ */
+
+#include "BenchModule.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint32_t RequestEvt = (State::EV_RESERVED_USER << 1);
+static const uint32_t ReplyEvt = (State::EV_RESERVED_USER << 2);
+static const uint32_t Window = ACTIVEMODULE_MAX_CALLS / 2;
+static const uint32_t ExpiryMillis = 50;
+
+
+/** Destino: responde a RequestEvt con sus mismos datos (instante de envio) salvo si esta en silencio */
+class Server : public BenchModule {
+  public:
+	Server(const char* name) : BenchModule(name), _silent(false) {}
+	void setSilent(bool silent) { _silent = silent; }
+
+  protected:
+	std::atomic<bool> _silent;
+
+	virtual State::StateResult Init_EventHandler(State::StateEvent* se){
+		if(se->evt == (State::EventType)RequestEvt){
+			State::Msg* msg = (State::Msg*)se->oe->value.p;
+			if(!_silent){
+				reply(msg, getMsgData<uint32_t>(msg), sizeof(uint32_t));
+			}
+			return State::HANDLED;
+		}
+		return BenchModule::Init_EventHandler(se);
+	}
+};
+
+
+/** Llamante: mide la latencia de cada respuesta y cuenta los vencimientos */
+class Client : public BenchModule {
+  public:
+	Client(const char* name) : BenchModule(name), _timeouts(0) {}
+
+	/** Llama al destino con el instante actual como datos */
+	uint32_t request(ActiveModule* server, uint32_t timeout){
+		uint32_t now = us_ticker_read();
+		return call(server, RequestEvt, &now, sizeof(now), ReplyEvt, timeout);
+	}
+
+	uint32_t timeouts() { return _timeouts; }
+	void resetTimeouts() { _timeouts = 0; }
+
+  protected:
+	std::atomic<uint32_t> _timeouts;
+
+	virtual State::StateResult Init_EventHandler(State::StateEvent* se){
+		if(se->evt == (State::EventType)ReplyEvt){
+			State::Msg* msg = (State::Msg*)se->oe->value.p;
+			if(isCallTimeout(msg)){
+				_timeouts++;
+			}
+			else if(_lat.size() < _lat.capacity()){
+				_lat.push_back(us_ticker_read() - *getMsgData<uint32_t>(msg));
+			}
+			_received++;
+			return State::HANDLED;
+		}
+		return BenchModule::Init_EventHandler(se);
+	}
+};
+
+
+/** Espera a que el llamante reciba 'count' respuestas o vencimientos */
+static void waitReceived(Client* client, uint32_t count){
+	while(client->received() < count){
+		Thread::yield();
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t calls = (argc > 1)? (uint32_t)atoi(argv[1]) : 20000;
+	Server* server = new Server("BmServer");
+	Client* client = new Client("BmClient");
+	server->start();
+	client->start();
+	server->waitStarted();
+	client->waitStarted();
+
+	benchPrintHeader("call -> respuesta");
+	const uint32_t timeouts[] = { 0, 1000 };
+	for(uint8_t t = 0; t < 2; t++){
+		// latencia: una llamada pendiente
+		client->reset(calls);
+		client->resetTimeouts();
+		for(uint32_t n = 0; n < calls; n++){
+			while(client->request(server, timeouts[t]) == 0){
+				Thread::yield();
+			}
+			waitReceived(client, n + 1);
+		}
+		std::vector<uint32_t> lat = client->latencies();
+
+		// llamadas/s: ventana de llamadas pendientes
+		client->reset(0);
+		uint64_t t0 = benchNow();
+		for(uint32_t n = 0; n < calls; n++){
+			while(n - client->received() >= Window || client->request(server, timeouts[t]) == 0){
+				Thread::yield();
+			}
+		}
+		waitReceived(client, calls);
+		double cps = (double)calls * 1000000.0 / (double)(benchNow() - t0);
+
+		char label[32];
+		snprintf(label, sizeof(label), "vencimiento %ums", (unsigned)timeouts[t]);
+		benchPrintLatency(label, lat, cps);
+		printf("%-28s %8u\n", "  vencimientos recibidos", (unsigned)client->timeouts());
+	}
+
+	// vencimiento: el destino no responde, se mide el retraso respecto al plazo
+	server->setSilent(true);
+	uint32_t expiries = 200;
+	client->reset(expiries);
+	client->resetTimeouts();
+	std::vector<uint32_t> late;
+	for(uint32_t n = 0; n < expiries; n += Window){
+		uint64_t start = benchNow();
+		for(uint32_t i = 0; i < Window; i++){
+			client->request(server, ExpiryMillis);
+		}
+		waitReceived(client, n + Window);
+		late.push_back((uint32_t)(benchNow() - start) - ExpiryMillis * 1000);
+	}
+	benchPrintHeader("vencimiento sin respuesta (retraso respecto al plazo)");
+	char label[32];
+	snprintf(label, sizeof(label), "plazo %ums, %u llamadas", (unsigned)ExpiryMillis, (unsigned)Window);
+	benchPrintLatency(label, late, 0);
+	printf("%-28s %8u de %u\n", "  vencimientos recibidos", (unsigned)client->timeouts(), (unsigned)((expiries + Window - 1) / Window * Window));
+	return 0;
+}
+
+/**** END OF FILE ****/
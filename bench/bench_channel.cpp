@@ -0,0 +1,149 @@
+/*
+ * bench_channel.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Salto entre modulos: publicacion en el broker (topic formateado, busqueda de suscriptores entre OtherSubs
+ *	suscripciones ajenas, subscriptionCb -> dispatchTopic -> newMessage/putMessage) frente a DirectChannel::send,
+ *	con y sin replica en un topic (setMirror). Para cada camino:
+ *	  - Latencia envio -> despacho en el modulo destino, con un unico mensaje pendiente.
+ *	  - Eventos/s en rafaga, desde el primer envio hasta el despacho del ultimo.
+ *	  - Coste del envio en el thread emisor durante la rafaga (ns por envio).
+ *	Con un unico nucleo los eventos/s dependen ademas de como alterna el planificador emisor y destino.
+ *
+ *	Uso: bench_channel [envios por medida]
+ */
+
+#include "BenchModule.h"
+#include "DirectChannel.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint16_t OtherSubs = 32;
+static const uint32_t Window = 32;
+static const char* SubBase = "bench/rx";
+static const char* MirrorTopic = "stat/rx/value";
+
+
+/** Destino: recibe PingEvt desde el topic SubBase/value/set o desde un DirectChannel */
+class Receiver : public BenchModule {
+  public:
+	Receiver(const char* name) : BenchModule(name) {
+		registerTopic("/value/set", callback(this, &Receiver::valueCb));
+		char topic[32];
+		snprintf(topic, sizeof(topic), "%s/#", SubBase);
+		MQ::MQClient::subscribe(topic, &_subscriptionCb);
+	}
+
+  protected:
+	virtual void subscriptionCb(const char* topic, void* msg, uint16_t msg_len){
+		dispatchTopic(topic, msg, msg_len);
+	}
+
+	/** Convierte el topic en un PingEvt con una copia de sus datos */
+	void valueCb(const char* /*topic*/, void* msg, uint16_t msg_len){
+		State::Msg* op = newMessage(PingEvt, msg, msg_len);
+		if(op){
+			putMessage(op);
+		}
+	}
+};
+
+
+/** Suscriptor ajeno al salto medido (ocupa el broker) */
+static void otherCb(const char* /*topic*/, void* /*msg*/, uint16_t /*msg_len*/) {}
+
+
+/** Envio por el broker, con el topic formateado a partir del topic base como en los modulos */
+static int32_t brokerSend(uint32_t now){
+	char topic[32];
+	snprintf(topic, sizeof(topic), "%s/value/set", SubBase);
+	return MQ::MQClient::publish(topic, &now, sizeof(now), NULL);
+}
+
+
+/** Camino medido */
+enum Path { PathBroker, PathDirect, PathMirror, NumPaths };
+
+
+/** Envia el instante actual por un camino */
+static bool send(Path path, DirectChannel<uint32_t>* direct, DirectChannel<uint32_t>* mirror){
+	uint32_t now = us_ticker_read();
+	switch(path){
+		case PathBroker: return brokerSend(now) == MQ::SUCCESS;
+		case PathDirect: return direct->send(now) == osOK;
+		default: return mirror->send(now) == osOK;
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t events = (argc > 1)? (uint32_t)atoi(argv[1]) : 20000;
+	MQ::MQBroker::start();
+	static MQ::SubscribeCallback other_cb = callback(otherCb);
+	static char other_topics[OtherSubs][24];
+	for(uint16_t i = 0; i < OtherSubs; i++){
+		snprintf(other_topics[i], sizeof(other_topics[i]), "bench/m%02u/#", i);
+		MQ::MQClient::subscribe(other_topics[i], &other_cb);
+	}
+	// observador de la replica
+	MQ::MQClient::subscribe(MirrorTopic, &other_cb);
+
+	// los topics base liberan el arranque, se asignan tras la construccion
+	Receiver* rx = new Receiver("BmRx");
+	rx->setPublicationBase("stat/rx");
+	rx->setSubscriptionBase(SubBase);
+	rx->waitStarted();
+	DirectChannel<uint32_t> direct(rx, BenchModule::PingEvt);
+	DirectChannel<uint32_t> mirror(rx, BenchModule::PingEvt);
+	mirror.setMirror(MirrorTopic, NULL);
+
+	const char* labels[NumPaths] = { "broker (publish)", "DirectChannel", "DirectChannel + replica" };
+	double send_ns[NumPaths];
+	benchPrintHeader("envio -> despacho en el modulo destino");
+	for(uint8_t p = 0; p < NumPaths; p++){
+		// latencia: un mensaje pendiente
+		rx->reset(events);
+		for(uint32_t n = 0; n < events; n++){
+			while(!send((Path)p, &direct, &mirror)){
+				Thread::yield();
+			}
+			while(rx->received() < n + 1){
+				Thread::yield();
+			}
+		}
+		std::vector<uint32_t> lat = rx->latencies();
+
+		// eventos/s: rafaga, y coste del envio en el emisor
+		rx->reset(0);
+		uint64_t send_us = 0;
+		uint64_t t0 = benchNow();
+		for(uint32_t n = 0; n < events; n++){
+			while(n - rx->received() >= Window){
+				Thread::yield();
+			}
+			uint64_t ts = benchNow();
+			while(!send((Path)p, &direct, &mirror)){
+				Thread::yield();
+			}
+			send_us += benchNow() - ts;
+		}
+		send_ns[p] = (double)send_us * 1000.0 / (double)events;
+		while(rx->received() < events){
+			Thread::yield();
+		}
+		benchPrintLatency(labels[p], lat, (double)events * 1000000.0 / (double)(benchNow() - t0));
+	}
+
+	printf("\n== coste del envio en el emisor\n");
+	for(uint8_t p = 0; p < NumPaths; p++){
+		printf("%-28s %10.1f ns/envio\n", labels[p], send_ns[p]);
+	}
+	return 0;
+}
+
+/**** END OF FILE ****/
@@ -0,0 +1,132 @@
+/*
+ * bench_coalesce.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Senales fusionables (setSignalCoalescing) con un consumidor mas lento que el productor: Keys sensores
+ *	(clave setMsgKey) publican lecturas cada PeriodUs a un modulo que tarda WorkUs en procesar cada una. Sin
+ *	fusion la cola se llena y el productor queda bloqueado en la politica por defecto (PolicyBlock); con fusion
+ *	cada sensor ocupa un unico mensaje pendiente con su ultima lectura. Para ambos casos se mide:
+ *	  - Lecturas procesadas y fusionadas, y ritmo real del productor.
+ *	  - Antiguedad de la lectura procesada (instante de proceso - instante de la lectura).
+ *	  - Retraso hasta procesar la ultima lectura de cada sensor una vez detenido el productor.
+ *
+ *	Uso: bench_coalesce [lecturas por medida]
+ */
+
+#include "BenchModule.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint32_t SensorEvt = (State::EV_RESERVED_USER << 1);
+static const uint8_t Keys = 4;
+static const uint32_t PeriodUs = 20;
+static const uint32_t WorkUs = 100;
+
+
+/** Lectura de un sensor */
+struct Reading {
+	uint32_t sent;
+	uint32_t seq;
+	uint8_t key;
+};
+
+
+/** Consumidor: procesa cada lectura en WorkUs y registra su antiguedad y la ultima lectura de cada sensor */
+class SensorModule : public BenchModule {
+  public:
+	SensorModule(const char* name, bool coalesce) : BenchModule(name) {
+		for(uint8_t k = 0; k < Keys; k++){
+			_last[k] = 0;
+		}
+		if(coalesce){
+			setSignalCoalescing(SensorEvt);
+		}
+	}
+
+	/** Postea una lectura del sensor 'key' */
+	osStatus post(uint8_t key, uint32_t seq){
+		Reading r = { us_ticker_read(), seq, key };
+		State::Msg* msg = newMessage(SensorEvt, &r, sizeof(r));
+		if(!msg){
+			return osErrorNoMemory;
+		}
+		setMsgKey(msg, key);
+		return putMessage(msg);
+	}
+
+	/** Espera a que se procese la lectura 'seq' de todos los sensores */
+	void waitLast(uint32_t seq){
+		for(uint8_t k = 0; k < Keys; k++){
+			while(_last[k] < seq){
+				Thread::yield();
+			}
+		}
+	}
+
+  protected:
+	std::atomic<uint32_t> _last[Keys];
+
+	virtual State::StateResult Init_EventHandler(State::StateEvent* se){
+		if(se->evt == (State::EventType)SensorEvt){
+			State::Msg* msg = (State::Msg*)se->oe->value.p;
+			const Reading* r = getMsgData<Reading>(msg);
+			uint64_t end = benchNow() + WorkUs;
+			while(benchNow() < end);
+			if(_lat.size() < _lat.capacity()){
+				_lat.push_back(us_ticker_read() - r->sent);
+			}
+			_last[r->key] = r->seq;
+			_received++;
+			return State::HANDLED;
+		}
+		return BenchModule::Init_EventHandler(se);
+	}
+};
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t readings = (argc > 1)? (uint32_t)atoi(argv[1]) : 20000;
+	uint32_t rounds = readings / Keys;
+
+	printf("\n== %u sensores, una lectura cada %u us, proceso %u us por lectura\n", Keys, (unsigned)PeriodUs, (unsigned)WorkUs);
+	printf("%-16s %10s %10s %12s %10s %10s %10s %12s\n", "", "lecturas", "procesadas", "fusionadas", "lect/s", "age p50", "age p99", "ultima(us)");
+	for(uint8_t c = 0; c < 2; c++){
+		SensorModule* module = new SensorModule((c)? "BmCoal" : "BmQueue", c != 0);
+		module->start();
+		module->waitStarted();
+		module->reset(readings);
+
+		// productor a ritmo fijo (se retrasa si putMessage bloquea)
+		uint64_t t0 = benchNow();
+		uint64_t next = t0;
+		for(uint32_t n = 1; n <= rounds; n++){
+			for(uint8_t k = 0; k < Keys; k++){
+				while(benchNow() < next);
+				next += PeriodUs;
+				while(module->post(k, n) != osOK){
+					Thread::yield();
+				}
+			}
+		}
+		uint64_t stop = benchNow();
+		module->waitLast(rounds);
+		uint32_t last_us = (uint32_t)(benchNow() - stop);
+
+		ActiveModule::OverloadStats stats;
+		module->getOverloadStats(stats);
+		std::vector<uint32_t>& age = module->latencies();
+		uint32_t p50 = benchPercentile(age, 0.50);
+		uint32_t p99 = benchPercentile(age, 0.99);
+		printf("%-16s %10u %10u %12u %10.0f %10u %10u %12u\n", (c)? "fusion" : "cola", (unsigned)(rounds * Keys),
+				(unsigned)module->received(), (unsigned)stats.merged, (double)(rounds * Keys) * 1000000.0 / (double)(stop - t0),
+				p50, p99, last_us);
+	}
+	return 0;
+}
+
+/**** END OF FILE ****/
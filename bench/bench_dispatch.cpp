@@ -0,0 +1,85 @@
+/*
+ * bench_dispatch.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Latencia putMessage -> despacho (run) y eventos por segundo de modulos con thread propio, escalando de 1 a 64
+ *	modulos.
+ *	  - Latencia: en cada ronda se envia un PingEvt a cada modulo y se espera a que todos lo procesen (sin cola).
+ *	  - Eventos/s: rafaga de mensajes repartidos entre los modulos, desde el envio del primero hasta el
+ *	    despacho del ultimo.
+ *
+ *	Uso: bench_dispatch [eventos por medida]
+ */
+
+#include "BenchModule.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint8_t MaxModules = 64;
+
+
+/** Espera a que los primeros 'count' modulos hayan procesado 'expected' mensajes cada uno */
+static void waitReceived(BenchModule** modules, uint8_t count, uint32_t expected){
+	for(uint8_t i = 0; i < count; i++){
+		while(modules[i]->received() < expected){
+			Thread::yield();
+		}
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t events = (argc > 1)? (uint32_t)atoi(argv[1]) : 20000;
+	BenchModule* modules[MaxModules];
+	char names[MaxModules][8];
+	for(uint8_t i = 0; i < MaxModules; i++){
+		snprintf(names[i], sizeof(names[i]), "Bm%02u", i);
+		modules[i] = new BenchModule(names[i]);
+		modules[i]->start();
+	}
+	for(uint8_t i = 0; i < MaxModules; i++){
+		modules[i]->waitStarted();
+	}
+
+	benchPrintHeader("putMessage -> run, modulos con thread propio");
+	for(uint8_t n = 1; n <= MaxModules; n *= 2){
+		// latencia: un mensaje pendiente por modulo en cada ronda
+		uint32_t rounds = events / n;
+		for(uint8_t i = 0; i < n; i++){
+			modules[i]->reset(rounds);
+		}
+		for(uint32_t r = 0; r < rounds; r++){
+			for(uint8_t i = 0; i < n; i++){
+				modules[i]->ping();
+			}
+			waitReceived(modules, n, r + 1);
+		}
+		std::vector<uint32_t> lat;
+		for(uint8_t i = 0; i < n; i++){
+			lat.insert(lat.end(), modules[i]->latencies().begin(), modules[i]->latencies().end());
+		}
+
+		// eventos/s: rafaga repartida entre los modulos
+		for(uint8_t i = 0; i < n; i++){
+			modules[i]->reset(0);
+		}
+		uint64_t t0 = benchNow();
+		for(uint32_t e = 0; e < rounds * n; e++){
+			modules[e % n]->ping();
+		}
+		waitReceived(modules, n, rounds);
+		double eps = (double)(rounds * n) * 1000000.0 / (double)(benchNow() - t0);
+
+		char label[32];
+		snprintf(label, sizeof(label), "%u modulos", n);
+		benchPrintLatency(label, lat, eps);
+	}
+	return 0;
+}
+
+/**** END OF FILE ****/
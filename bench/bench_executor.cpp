@@ -0,0 +1,111 @@
+/*
+ * bench_executor.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Comparativa de modulos con thread propio frente a modulos sobre un ActiveExecutor de Workers threads, con 8,
+ *	32 y 64 modulos:
+ *	  - RAM: objetos de los modulos mas las pilas solicitadas (tamano en el target) y, en modo executor, sus
+ *	    listas. Se indica tambien el maximo de pila utilizado por el thread de un modulo en el host.
+ *	  - Latencia putMessage -> run y eventos por segundo, como en bench_dispatch.
+ *
+ *	Uso: bench_executor [eventos por medida]
+ */
+
+#include "BenchModule.h"
+#include "ActiveExecutor.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint8_t Workers = 2;
+static const uint8_t Sizes[] = { 8, 32, 64 };
+
+
+/** Mide latencia y eventos/s de 'n' modulos e imprime el resultado */
+static void measure(const char* label, BenchModule** modules, uint8_t n, uint32_t events){
+	uint32_t rounds = events / n;
+	for(uint8_t i = 0; i < n; i++){
+		modules[i]->reset(rounds);
+	}
+	for(uint32_t r = 0; r < rounds; r++){
+		for(uint8_t i = 0; i < n; i++){
+			modules[i]->ping();
+		}
+		for(uint8_t i = 0; i < n; i++){
+			while(modules[i]->received() < r + 1){
+				Thread::yield();
+			}
+		}
+	}
+	std::vector<uint32_t> lat;
+	for(uint8_t i = 0; i < n; i++){
+		lat.insert(lat.end(), modules[i]->latencies().begin(), modules[i]->latencies().end());
+		modules[i]->reset(0);
+	}
+	uint64_t t0 = benchNow();
+	for(uint32_t e = 0; e < rounds * n; e++){
+		modules[e % n]->ping();
+	}
+	for(uint8_t i = 0; i < n; i++){
+		while(modules[i]->received() < rounds){
+			Thread::yield();
+		}
+	}
+	double eps = (double)(rounds * n) * 1000000.0 / (double)(benchNow() - t0);
+	benchPrintLatency(label, lat, eps);
+}
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t events = (argc > 1)? (uint32_t)atoi(argv[1]) : 20000;
+	char label[32];
+
+	// pila maxima utilizada por un modulo tras procesar un mensaje
+	BenchModule* probe = new BenchModule("BmProbe");
+	probe->start();
+	probe->waitStarted();
+	probe->ping();
+	while(probe->received() < 1){
+		Thread::yield();
+	}
+	ActiveModule::MemoryReport r;
+	probe->getMemoryReport(r);
+
+	printf("\n== RAM (target): objetos de los modulos + pilas solicitadas de %u bytes (maximo utilizado en el host: %u)\n", OS_STACK_SIZE, r.stack_max);
+	printf("%-28s %12s %12s\n", "", "thread", "executor");
+	for(uint8_t s = 0; s < sizeof(Sizes); s++){
+		uint8_t n = Sizes[s];
+		uint32_t threads = n * (sizeof(BenchModule) + OS_STACK_SIZE);
+		// listas de modulos listos (3 bandas) y de modulos asociados
+		uint32_t executor = n * sizeof(BenchModule) + Workers * OS_STACK_SIZE + 4 * n * sizeof(ActiveModule*);
+		snprintf(label, sizeof(label), "%u modulos", n);
+		printf("%-28s %12u %12u\n", label, threads, executor);
+	}
+
+	benchPrintHeader("putMessage -> run, thread propio frente a executor");
+	for(uint8_t s = 0; s < sizeof(Sizes); s++){
+		uint8_t n = Sizes[s];
+		BenchModule* modules[64];
+		char names[64][8];
+		ActiveExecutor* ex = new ActiveExecutor("BmExec", Workers, n);
+		for(uint8_t mode = 0; mode < 2; mode++){
+			for(uint8_t i = 0; i < n; i++){
+				snprintf(names[i], sizeof(names[i]), "B%c%02u", (mode)? 'e' : 't', i);
+				modules[i] = (mode)? new BenchModule(names[i], ex) : new BenchModule(names[i]);
+				modules[i]->start();
+			}
+			for(uint8_t i = 0; i < n; i++){
+				modules[i]->waitStarted();
+			}
+			snprintf(label, sizeof(label), "%u modulos, %s", n, (mode)? "executor" : "thread");
+			measure(label, modules, n, events);
+		}
+	}
+	return 0;
+}
+
+/**** END OF FILE ****/
@@ -0,0 +1,122 @@
+/*
+ * bench_mailbox.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Comparativa del mailbox del RTOS (Queue) frente al mailbox lock-free (MPSCQueue):
+ *	  - put/get: coste por operacion de las colas, en rafagas de la capacidad de la cola desde un unico thread.
+ *	  - Contencion: 1 a 8 productores posteando PingEvt a un modulo con cada tipo de mailbox; latencia
+ *	    putMessage -> run y eventos por segundo.
+ *
+ *	Uso: bench_mailbox [mensajes por medida]
+ */
+
+#include "BenchModule.h"
+#include "MPSCQueue.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint32_t BurstSize = 32;
+static const uint8_t MaxProducers = 8;
+
+
+/** Modulo de medida con el tipo de mailbox seleccionado */
+class MailboxModule : public BenchModule {
+  public:
+	MailboxModule(const char* name, MailboxType type) : BenchModule(name) {
+		setMailboxType(type);
+	}
+};
+
+
+/** Productor de la medida de contencion */
+struct Producer {
+	BenchModule* module;
+	uint32_t count;
+	void run(){
+		for(uint32_t i = 0; i < count; i++){
+			// sin bloques libres o con el carril lleno se reintenta
+			while(module->ping() != osOK){
+				Thread::yield();
+			}
+		}
+	}
+};
+
+
+/** Mide el coste por operacion put+get de una cola en rafagas de BurstSize */
+template<typename Q>
+static double putGet(Q& q, State::Msg* msgs, uint32_t count, bool (*put)(Q&, State::Msg*), State::Msg* (*get)(Q&)){
+	uint64_t t0 = benchNow();
+	for(uint32_t n = 0; n < count; n += BurstSize){
+		for(uint32_t i = 0; i < BurstSize; i++){
+			put(q, &msgs[i]);
+		}
+		for(uint32_t i = 0; i < BurstSize; i++){
+			get(q);
+		}
+	}
+	return (double)(benchNow() - t0) * 1000.0 / (double)count;
+}
+
+
+static bool queuePut(Queue<State::Msg, BurstSize>& q, State::Msg* msg) { return q.put(msg, 0) == osOK; }
+static State::Msg* queueGet(Queue<State::Msg, BurstSize>& q) { return (State::Msg*)q.get(0).value.p; }
+static bool mpscPut(MPSCQueue<State::Msg, BurstSize>& q, State::Msg* msg) { return q.put(msg); }
+static State::Msg* mpscGet(MPSCQueue<State::Msg, BurstSize>& q) { return q.get(); }
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t events = (argc > 1)? (uint32_t)atoi(argv[1]) : 200000;
+
+	// put/get sin contencion
+	static State::Msg msgs[BurstSize];
+	static Queue<State::Msg, BurstSize> queue;
+	static MPSCQueue<State::Msg, BurstSize> mpsc;
+	printf("\n== put+get en rafagas de %u, un thread\n", BurstSize);
+	printf("%-28s %10.1f ns/op\n", "Queue", putGet(queue, msgs, events, queuePut, queueGet));
+	printf("%-28s %10.1f ns/op\n", "MPSCQueue", putGet(mpsc, msgs, events, mpscPut, mpscGet));
+
+	// contencion: varios productores sobre un modulo
+	events /= 10;
+	MailboxModule* modules[] = { new MailboxModule("BmRtos", ActiveModule::RtosMailbox), new MailboxModule("BmLockFree", ActiveModule::LockFreeMailbox) };
+	const char* names[] = { "Queue", "MPSCQueue" };
+	for(uint8_t m = 0; m < 2; m++){
+		modules[m]->start();
+		modules[m]->waitStarted();
+	}
+	benchPrintHeader("putMessage -> run con productores concurrentes");
+	for(uint8_t p = 1; p <= MaxProducers; p *= 2){
+		for(uint8_t m = 0; m < 2; m++){
+			BenchModule* mod = modules[m];
+			mod->reset(events);
+			Producer producers[MaxProducers];
+			Thread* threads[MaxProducers];
+			uint64_t t0 = benchNow();
+			for(uint8_t i = 0; i < p; i++){
+				producers[i].module = mod;
+				producers[i].count = events / p;
+				threads[i] = new Thread(osPriorityNormal, OS_STACK_SIZE);
+				threads[i]->start(callback(&producers[i], &Producer::run));
+			}
+			for(uint8_t i = 0; i < p; i++){
+				threads[i]->join();
+				delete threads[i];
+			}
+			while(mod->received() < (events / p) * p){
+				Thread::yield();
+			}
+			double eps = (double)((events / p) * p) * 1000000.0 / (double)(benchNow() - t0);
+			char label[32];
+			snprintf(label, sizeof(label), "%s, %u productores", names[m], p);
+			benchPrintLatency(label, mod->latencies(), eps);
+		}
+	}
+	return 0;
+}
+
+/**** END OF FILE ****/
@@ -0,0 +1,169 @@
+/*
+ * bench_refbuffer.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Publicacion de un payload a Subs modulos suscritos, que lo entregan a su maquina de estados con newMessageRef
+ *	(como la plantilla y los modulos generados), en dos variantes:
+ *	  - copia: el publicador publica un buffer propio y cada suscriptor copia los datos en su mensaje.
+ *	  - RefBuffer: el publicador publica con ActiveModule::publish un RefBuffer del pool por defecto
+ *	    (ACTIVEMODULE_REF_BUFFERS) y cada suscriptor lo retiene sin copiarlo.
+ *	El payload lleva su propia direccion, de forma que el manejador del suscriptor detecta si los datos recibidos
+ *	son el buffer publicado (sin copia). Para cada tamano se mide el coste de la publicacion en el publicador, la
+ *	latencia publicacion -> despacho y las entregas sin copia. Los RefBuffer que caben en el pool deben llegar
+ *	siempre sin copia (el benchmark termina con error en otro caso); los mayores se reservan del heap y se copian.
+ *
+ *	Uso: bench_refbuffer [publicaciones por medida]
+ */
+
+#include "BenchModule.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint8_t Subs = 4;
+static const char* SubBase = "bench/ref";
+static const uint16_t Sizes[] = { 16, 64, ACTIVEMODULE_REF_BUFFER_SIZE, 4 * ACTIVEMODULE_REF_BUFFER_SIZE };
+
+
+/** Cabecera del payload: instante de envio (PingEvt) y direccion del propio payload */
+struct Payload {
+	uint32_t sent;
+	const void* self;
+};
+
+
+/** Suscriptor: entrega el payload como PingEvt con newMessageRef y cuenta las entregas sin copia */
+class Sink : public BenchModule {
+  public:
+	Sink(const char* name) : BenchModule(name), _shared(0) {
+		registerTopic("/data", callback(this, &Sink::dataCb));
+		char topic[32];
+		snprintf(topic, sizeof(topic), "%s/#", SubBase);
+		MQ::MQClient::subscribe(topic, &_subscriptionCb);
+	}
+
+	uint32_t shared() { return _shared; }
+	void resetShared() { _shared = 0; }
+
+  protected:
+	std::atomic<uint32_t> _shared;
+
+	virtual void subscriptionCb(const char* topic, void* msg, uint16_t msg_len){
+		dispatchTopic(topic, msg, msg_len);
+	}
+
+	void dataCb(const char* /*topic*/, void* msg, uint16_t msg_len){
+		State::Msg* op = newMessageRef(PingEvt, msg, msg_len);
+		if(op){
+			putMessage(op);
+		}
+	}
+
+	virtual State::StateResult Init_EventHandler(State::StateEvent* se){
+		if(se->evt == (State::EventType)PingEvt){
+			const Payload* p = getMsgData<Payload>((State::Msg*)se->oe->value.p);
+			if(p->self == p){
+				_shared++;
+			}
+		}
+		return BenchModule::Init_EventHandler(se);
+	}
+};
+
+
+/** Publicador: publica en SubBase/data con ActiveModule::publish */
+class Source : public BenchModule {
+  public:
+	Source(const char* name) : BenchModule(name) {}
+
+	/** Prepara el topic de publicacion (tras asignar el topic base) */
+	void open() { _data_topic = createPubTopic("data"); }
+
+	/** Publica 'size' bytes en un RefBuffer o en un buffer propio */
+	bool send(uint16_t size, bool ref){
+		static uint8_t local[4 * ACTIVEMODULE_REF_BUFFER_SIZE];
+		Payload* p = (Payload*)((ref)? RefBuffer::create(size) : local);
+		if(!p){
+			return false;
+		}
+		p->self = p;
+		p->sent = us_ticker_read();
+		if(ref){
+			return publish(_data_topic, p) == MQ::SUCCESS;
+		}
+		return MQ::MQClient::publish(_data_topic.name, p, size, NULL) == MQ::SUCCESS;
+	}
+
+  protected:
+	TopicHandle _data_topic;
+};
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t events = (argc > 1)? (uint32_t)atoi(argv[1]) : 20000;
+	MQ::MQBroker::start();
+
+	Sink* sinks[Subs];
+	static char names[Subs][8];
+	for(uint8_t s = 0; s < Subs; s++){
+		snprintf(names[s], sizeof(names[s]), "BmSk%u", s);
+		sinks[s] = new Sink(names[s]);
+		sinks[s]->setSubscriptionBase(SubBase);
+		sinks[s]->setPublicationBase("stat/sink");
+		sinks[s]->waitStarted();
+	}
+	Source* src = new Source("BmSrc");
+	src->setPublicationBase(SubBase);
+	src->setSubscriptionBase("bench/src");
+	src->waitStarted();
+	src->open();
+
+	bool ok = true;
+	printf("\n== publicacion a %u suscriptores (newMessageRef), pool de %u RefBuffer de %u bytes\n", Subs, ACTIVEMODULE_REF_BUFFERS, ACTIVEMODULE_REF_BUFFER_SIZE);
+	printf("%-20s %12s %10s %10s %14s\n", "", "ns/publica", "p50(us)", "p99(us)", "sin copia(%)");
+	for(uint8_t z = 0; z < sizeof(Sizes)/sizeof(Sizes[0]); z++){
+		for(uint8_t r = 0; r < 2; r++){
+			for(uint8_t s = 0; s < Subs; s++){
+				sinks[s]->reset(events);
+				sinks[s]->resetShared();
+			}
+			// un unico payload pendiente: el pool no se agota y se mide el camino sin colas
+			uint64_t send_us = 0;
+			for(uint32_t n = 0; n < events; n++){
+				uint64_t ts = benchNow();
+				while(!src->send(Sizes[z], r != 0)){
+					Thread::yield();
+				}
+				send_us += benchNow() - ts;
+				for(uint8_t s = 0; s < Subs; s++){
+					while(sinks[s]->received() < n + 1){
+						Thread::yield();
+					}
+				}
+			}
+			std::vector<uint32_t> lat;
+			uint32_t shared = 0;
+			for(uint8_t s = 0; s < Subs; s++){
+				lat.insert(lat.end(), sinks[s]->latencies().begin(), sinks[s]->latencies().end());
+				shared += sinks[s]->shared();
+			}
+			double pct = (double)shared * 100.0 / (double)(events * Subs);
+			char label[32];
+			snprintf(label, sizeof(label), "%s, %u bytes", (r)? "RefBuffer" : "copia", Sizes[z]);
+			printf("%-20s %12.1f %10u %10u %14.1f\n", label, (double)send_us * 1000.0 / (double)events,
+					benchPercentile(lat, 0.50), benchPercentile(lat, 0.99), pct);
+			// los RefBuffer del pool deben llegar sin copia a todos los suscriptores
+			if(r && RefBuffer::blockSize(Sizes[z]) <= RefBuffer::blockSize(ACTIVEMODULE_REF_BUFFER_SIZE) && shared != events * Subs){
+				printf("ERROR: %u de %u entregas de RefBuffer copiadas\n", (unsigned)(events * Subs - shared), (unsigned)(events * Subs));
+				ok = false;
+			}
+		}
+	}
+	return (ok)? 0 : 1;
+}
+
+/**** END OF FILE ****/
@@ -0,0 +1,106 @@
+/*
+ * bench_startup.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Arranque de NumModules modulos cuyo estado inicial (Init EV_ENTRY) tarda InitMillis en completarse (ej.
+ *	restauracion de la configuracion NV), con tres grafos de dependencias (dependsOn):
+ *	  - Cadena: cada modulo depende del anterior (equivale al arranque secuencial).
+ *	  - Capas: un modulo base, del que dependen el resto repartidos en capas de Fanout modulos.
+ *	  - Paralelo: sin dependencias.
+ *	Se mide el tiempo desde la construccion del primer modulo hasta que todos completan su estado inicial y el
+ *	mayor getStartupTime. Con InitMillis = 0 la cadena mide el coste de notificacion entre dependencias.
+ *
+ *	Uso: bench_startup [ms del estado inicial]
+ */
+
+#include "BenchModule.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint8_t NumModules = 16;
+static const uint8_t Fanout = ActiveModule::MaxDependencies;
+
+
+/** Modulo con un estado inicial de duracion configurable */
+class SlowInit : public BenchModule {
+  public:
+	SlowInit(const char* name, uint32_t init_ms) : BenchModule(name), _init_ms(init_ms) {}
+
+  protected:
+	uint32_t _init_ms;
+
+	virtual State::StateResult Init_EventHandler(State::StateEvent* se){
+		if(se->evt == State::EV_ENTRY && _init_ms){
+			Thread::wait(_init_ms);
+		}
+		return BenchModule::Init_EventHandler(se);
+	}
+};
+
+
+/** Grafo de dependencias */
+enum Graph { GraphChain, GraphLayers, GraphParallel, NumGraphs };
+
+
+/** Construye y arranca los modulos con un grafo de dependencias y mide su arranque
+ *  @param graph Grafo
+ *  @param init_ms Duracion del estado inicial
+ *  @param max_startup Recibe el mayor getStartupTime
+ *  @return Microsegundos hasta que todos los modulos completan su estado inicial
+ */
+static uint32_t bringUp(Graph graph, uint32_t init_ms, uint32_t& max_startup){
+	static uint16_t instance = 0;
+	static char names[NumGraphs * 2][NumModules][8];
+	char (*name)[8] = names[instance++ % (NumGraphs * 2)];
+	SlowInit* modules[NumModules];
+	uint64_t t0 = benchNow();
+	for(uint8_t i = 0; i < NumModules; i++){
+		snprintf(name[i], sizeof(name[i]), "Bm%02u", i);
+		modules[i] = new SlowInit(name[i], init_ms);
+		if(i == 0 || graph == GraphParallel){
+			continue;
+		}
+		// capa k (k >= 1): modulos [1 + (k-1)*Fanout, k*Fanout], dependen del primero de la capa anterior
+		uint8_t dep = (graph == GraphChain)? i - 1 : (i <= Fanout)? 0 : 1 + ((i - 1) / Fanout - 1) * Fanout;
+		bool added = modules[i]->dependsOn(modules[dep]);
+		MBED_ASSERT(added);
+	}
+	for(uint8_t i = 0; i < NumModules; i++){
+		modules[i]->start();
+	}
+	for(uint8_t i = 0; i < NumModules; i++){
+		modules[i]->waitStarted();
+	}
+	uint32_t elapsed = (uint32_t)(benchNow() - t0);
+	max_startup = 0;
+	for(uint8_t i = 0; i < NumModules; i++){
+		max_startup = (modules[i]->getStartupTime() > max_startup)? modules[i]->getStartupTime() : max_startup;
+	}
+	return elapsed;
+}
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t init_ms = (argc > 1)? (uint32_t)atoi(argv[1]) : 10;
+	const char* labels[NumGraphs] = { "cadena", "capas", "paralelo" };
+	const uint32_t inits[] = { 0, init_ms };
+
+	printf("\n== Arranque de %u modulos\n%-28s %14s %16s\n", NumModules, "", "total(us)", "max startup(ms)");
+	for(uint8_t t = 0; t < 2; t++){
+		for(uint8_t g = 0; g < NumGraphs; g++){
+			uint32_t max_startup;
+			uint32_t elapsed = bringUp((Graph)g, inits[t], max_startup);
+			char label[32];
+			snprintf(label, sizeof(label), "%s, init %ums", labels[g], (unsigned)inits[t]);
+			printf("%-28s %14u %16u\n", label, (unsigned)elapsed, (unsigned)max_startup);
+		}
+	}
+	return 0;
+}
+
+/**** END OF FILE ****/
@@ -0,0 +1,193 @@
+/*
+ * bench_statetable.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Maquina de 10 estados y ActiveModule::MaxUserSignals senales (29: el convenio EV_RESERVED_USER << i no admite
+ *	30), con 25 senales con transicion en cada estado (250 transiciones) y el resto ignoradas:
+ *	  - Despacho directo: StateTable::dispatch frente a StateMachine con un manejador switch por senal y
+ *	    transiciones tranState/nextState (EV_EXIT/EV_ENTRY a traves de Callback). Coste por evento.
+ *	  - Modulo: eventos/s de putMessage -> run -> StateTable::dispatch en un modulo con thread propio.
+ *
+ *	Uso: bench_statetable [eventos por medida]
+ */
+
+#include "BenchModule.h"
+#include "StateTable.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint8_t NumStates = 10;
+static const uint8_t NumSignals = ActiveModule::MaxUserSignals;
+static const uint8_t TransitionsPerState = 25;
+
+#define SIG(g)			((uint32_t)State::EV_RESERVED_USER << (g))
+#define TR(C, s, g)		{ s, SIG(g), NULL, &C::step, (uint8_t)(((s) + (g) + 1) % NumStates) }
+#define ROW(C, s)		TR(C,s,0), TR(C,s,1), TR(C,s,2), TR(C,s,3), TR(C,s,4), TR(C,s,5), TR(C,s,6), TR(C,s,7), TR(C,s,8), \
+						TR(C,s,9), TR(C,s,10), TR(C,s,11), TR(C,s,12), TR(C,s,13), TR(C,s,14), TR(C,s,15), TR(C,s,16), \
+						TR(C,s,17), TR(C,s,18), TR(C,s,19), TR(C,s,20), TR(C,s,21), TR(C,s,22), TR(C,s,23), TR(C,s,24)
+#define TABLE(C)		ROW(C,0), ROW(C,1), ROW(C,2), ROW(C,3), ROW(C,4), ROW(C,5), ROW(C,6), ROW(C,7), ROW(C,8), ROW(C,9)
+
+
+/** Propietario de la tabla en el despacho directo */
+class TableOwner {
+  public:
+	typedef StateTable<TableOwner, NumStates, NumSignals> Fsm;
+	uint32_t steps;
+	void step(State::Msg* /*msg*/) { steps++; }
+	static const Fsm::StateDef States[NumStates];
+	static constexpr Fsm::Transition Transitions[] = { TABLE(TableOwner) };
+	static constexpr Fsm::Index TransitionIndex = Fsm::index(Transitions);
+	Fsm fsm;
+	TableOwner() : steps(0), fsm(this, States, TransitionIndex) {}
+};
+
+const TableOwner::Fsm::StateDef TableOwner::States[NumStates] = {};
+constexpr TableOwner::Fsm::Transition TableOwner::Transitions[];
+constexpr TableOwner::Fsm::Index TableOwner::TransitionIndex;
+
+
+/** Equivalente con StateMachine: un State por estado, manejador switch y transiciones tranState/nextState */
+class SwitchMachine : public StateMachine {
+  public:
+	uint32_t steps;
+	SwitchMachine() : steps(0), _cur(0) {
+		for(uint8_t i = 0; i < NumStates; i++){
+			_st[i].setHandler(callback(this, &SwitchMachine::handler));
+		}
+		initState(&_st[0]);
+	}
+
+  private:
+	State _st[NumStates];
+	uint8_t _cur;
+
+	State::StateResult go(uint8_t g){
+		if(g >= TransitionsPerState){
+			return State::IGNORED;
+		}
+		steps++;
+		uint8_t target = (_cur + g + 1) % NumStates;
+		tranState(&_st[target]);
+		_cur = target;
+		nextState();
+		return State::HANDLED;
+	}
+
+	State::StateResult handler(State::StateEvent* se){
+		switch((uint32_t)se->evt){
+			case State::EV_ENTRY:
+			case State::EV_EXIT:
+				return State::HANDLED;
+			case SIG(0): return go(0);		case SIG(1): return go(1);		case SIG(2): return go(2);
+			case SIG(3): return go(3);		case SIG(4): return go(4);		case SIG(5): return go(5);
+			case SIG(6): return go(6);		case SIG(7): return go(7);		case SIG(8): return go(8);
+			case SIG(9): return go(9);		case SIG(10): return go(10);	case SIG(11): return go(11);
+			case SIG(12): return go(12);	case SIG(13): return go(13);	case SIG(14): return go(14);
+			case SIG(15): return go(15);	case SIG(16): return go(16);	case SIG(17): return go(17);
+			case SIG(18): return go(18);	case SIG(19): return go(19);	case SIG(20): return go(20);
+			case SIG(21): return go(21);	case SIG(22): return go(22);	case SIG(23): return go(23);
+			case SIG(24): return go(24);	case SIG(25): return go(25);	case SIG(26): return go(26);
+			case SIG(27): return go(27);	case SIG(28): return go(28);
+			default:
+				return State::IGNORED;
+		}
+	}
+};
+
+
+/** Modulo con la maquina de estados en su estado Init */
+class FsmModule : public BenchModule {
+  public:
+	typedef StateTable<FsmModule, NumStates, NumSignals> Fsm;
+	FsmModule(const char* name) : BenchModule(name), _fsm(this, States, TransitionIndex) {}
+
+	/** Postea la senal g */
+	osStatus post(uint8_t g){
+		State::Msg* msg = newMessage(SIG(g), NULL, 0);
+		return (msg)? putMessage(msg) : osErrorNoMemory;
+	}
+
+  protected:
+	void step(State::Msg* /*msg*/) {}
+	static const Fsm::StateDef States[NumStates];
+	static constexpr Fsm::Transition Transitions[] = { TABLE(FsmModule) };
+	static constexpr Fsm::Index TransitionIndex = Fsm::index(Transitions);
+	Fsm _fsm;
+
+	virtual State::StateResult Init_EventHandler(State::StateEvent* se){
+		State::StateResult r = _fsm.dispatch(se);
+		if(se->evt != State::EV_ENTRY){
+			_received++;
+		}
+		return r;
+	}
+};
+
+const FsmModule::Fsm::StateDef FsmModule::States[NumStates] = {};
+constexpr FsmModule::Fsm::Transition FsmModule::Transitions[];
+constexpr FsmModule::Fsm::Index FsmModule::TransitionIndex;
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t events = (argc > 1)? (uint32_t)atoi(argv[1]) : 2000000;
+
+	// secuencia de senales pseudoaleatoria comun a todas las medidas
+	static uint8_t seq[1024];
+	uint32_t r = 12345;
+	for(uint16_t i = 0; i < sizeof(seq); i++){
+		r = r * 1103515245 + 12345;
+		seq[i] = (r >> 16) % NumSignals;
+	}
+	static State::Msg msgs[NumSignals];
+	static osEvent oes[NumSignals];
+	for(uint8_t g = 0; g < NumSignals; g++){
+		msgs[g].sig = SIG(g);
+		msgs[g].msg = NULL;
+		oes[g].status = osEventMessage;
+		oes[g].value.p = &msgs[g];
+	}
+
+	printf("\n== %u estados x %u senales, despacho directo\n", NumStates, NumSignals);
+	TableOwner table;
+	uint64_t t0 = benchNow();
+	for(uint32_t e = 0; e < events; e++){
+		uint8_t g = seq[e & (sizeof(seq) - 1)];
+		State::StateEvent se = { (State::EventType)SIG(g), &oes[g] };
+		table.fsm.dispatch(&se);
+	}
+	double table_ns = (double)(benchNow() - t0) * 1000.0 / (double)events;
+	SwitchMachine sm;
+	t0 = benchNow();
+	for(uint32_t e = 0; e < events; e++){
+		sm.run(&oes[seq[e & (sizeof(seq) - 1)]]);
+	}
+	double switch_ns = (double)(benchNow() - t0) * 1000.0 / (double)events;
+	printf("%-28s %10.1f ns/evento %12.0f eventos/s (%u transiciones)\n", "StateTable", table_ns, 1e9 / table_ns, (unsigned)table.steps);
+	printf("%-28s %10.1f ns/evento %12.0f eventos/s (%u transiciones)\n", "StateMachine + switch", switch_ns, 1e9 / switch_ns, (unsigned)sm.steps);
+
+	// modulo: putMessage -> run -> StateTable::dispatch
+	events /= 20;
+	FsmModule* module = new FsmModule("BmFsm");
+	module->start();
+	module->waitStarted();
+	module->reset(0);
+	t0 = benchNow();
+	for(uint32_t e = 0; e < events; e++){
+		while(module->post(seq[e & (sizeof(seq) - 1)]) != osOK){
+			Thread::yield();
+		}
+	}
+	while(module->received() < events){
+		Thread::yield();
+	}
+	double eps = (double)events * 1000000.0 / (double)(benchNow() - t0);
+	printf("%-28s %12.0f eventos/s\n", "Modulo (putMessage -> run)", eps);
+	return 0;
+}
+
+/**** END OF FILE ****/
@@ -0,0 +1,144 @@
+/*
+ * bench_static.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	StaticActiveModule (pool, cola y pila en el propio objeto, SignalTable resuelta en compilacion) frente a
+ *	ActiveModule (BenchModule, despacho en Init_EventHandler). El modulo estatico declara TableSignals senales
+ *	en su SignalTable, con PingEvt en la ultima entrada, de forma que el despacho no depende de su posicion:
+ *	  - Latencia newMessage/putMessage -> despacho, con un unico mensaje pendiente.
+ *	  - Eventos/s en rafaga (maximo Window mensajes pendientes), desde el primer envio hasta el ultimo despacho.
+ *
+ *	Uso: bench_static [eventos por medida]
+ */
+
+#include "BenchModule.h"
+#include "StaticActiveModule.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint32_t QueueDepth = 64;
+static const uint32_t Window = 32;
+static const uint8_t TableSignals = 16;
+
+#define SIG(g)			((uint32_t)State::EV_RESERVED_USER << (g))
+
+
+/** Modulo estatico: PingEvt en la ultima entrada de su SignalTable */
+class StaticPing : public StaticActiveModule<StaticPing, QueueDepth, 16 * 1024> {
+  public:
+	StaticPing(const char* name) : StaticActiveModule<StaticPing, QueueDepth, 16 * 1024>(name, osPriorityNormal, NULL), _received(0) {}
+
+	/** Envia un PingEvt con el instante actual */
+	osStatus ping(){
+		uint32_t now = us_ticker_read();
+		State::Msg* msg = newMessage(BenchModule::PingEvt, &now, sizeof(now));
+		return (msg)? putMessage(msg) : osErrorNoMemory;
+	}
+
+	/** Reinicia las muestras de latencia, reservando espacio para 'samples' */
+	void reset(size_t samples){
+		_lat.clear();
+		_lat.reserve(samples);
+		_received = 0;
+	}
+
+	uint32_t received() { return _received; }
+	std::vector<uint32_t>& latencies() { return _lat; }
+
+	State::StateResult Init_EventHandler(State::StateEvent* se){
+		if(se->evt == State::EV_ENTRY){
+			_ready = true;
+			return State::HANDLED;
+		}
+		return State::IGNORED;
+	}
+
+	State::StateResult onPing(State::Msg* msg){
+		uint32_t sent = *(uint32_t*)msg->msg;
+		if(_lat.size() < _lat.capacity()){
+			_lat.push_back(us_ticker_read() - sent);
+		}
+		_received++;
+		return State::HANDLED;
+	}
+
+	State::StateResult onOther(State::Msg* /*msg*/){
+		return State::HANDLED;
+	}
+
+	static constexpr SignalEntry SignalTable[TableSignals] = {
+		{ SIG(1), &StaticPing::onOther }, { SIG(2), &StaticPing::onOther }, { SIG(3), &StaticPing::onOther },
+		{ SIG(4), &StaticPing::onOther }, { SIG(5), &StaticPing::onOther }, { SIG(6), &StaticPing::onOther },
+		{ SIG(7), &StaticPing::onOther }, { SIG(8), &StaticPing::onOther }, { SIG(9), &StaticPing::onOther },
+		{ SIG(10), &StaticPing::onOther }, { SIG(11), &StaticPing::onOther }, { SIG(12), &StaticPing::onOther },
+		{ SIG(13), &StaticPing::onOther }, { SIG(14), &StaticPing::onOther }, { SIG(15), &StaticPing::onOther },
+		{ BenchModule::PingEvt, &StaticPing::onPing },
+	};
+
+  protected:
+	std::atomic<uint32_t> _received;
+	std::vector<uint32_t> _lat;
+};
+
+constexpr StaticPing::SignalEntry StaticPing::SignalTable[];
+
+
+/** Mide latencia y eventos/s de un modulo con ping/reset/received/latencies */
+template<class M>
+static void measure(const char* label, M* module, uint32_t events){
+	// latencia: un mensaje pendiente
+	module->reset(events);
+	for(uint32_t n = 0; n < events; n++){
+		while(module->ping() != osOK){
+			Thread::yield();
+		}
+		while(module->received() < n + 1){
+			Thread::yield();
+		}
+	}
+	std::vector<uint32_t> lat = module->latencies();
+
+	// eventos/s: rafaga
+	module->reset(0);
+	uint64_t t0 = benchNow();
+	for(uint32_t n = 0; n < events; n++){
+		while(n - module->received() >= Window){
+			Thread::yield();
+		}
+		while(module->ping() != osOK){
+			Thread::yield();
+		}
+	}
+	while(module->received() < events){
+		Thread::yield();
+	}
+	benchPrintLatency(label, lat, (double)events * 1000000.0 / (double)(benchNow() - t0));
+}
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t events = (argc > 1)? (uint32_t)atoi(argv[1]) : 20000;
+
+	BenchModule* dyn = new BenchModule("BmDyn");
+	dyn->start();
+	dyn->waitStarted();
+	StaticPing* stat = new StaticPing("BmStat");
+	stat->start();
+	while(!stat->ready()){
+		Thread::wait(1);
+	}
+
+	benchPrintHeader("newMessage/putMessage -> despacho");
+	measure("ActiveModule", dyn, events);
+	char label[32];
+	snprintf(label, sizeof(label), "StaticActiveModule, %u sen", TableSignals);
+	measure(label, stat, events);
+	return 0;
+}
+
+/**** END OF FILE ****/
@@ -0,0 +1,77 @@
+/*
+ * bench_topics.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Resolucion de topics suscritos con 5, 20 y 100 tokens registrados: cadena de comparaciones isTopicToken (como
+ *	en los subscriptionCb sin registerTopic) frente a TopicMap::find. Se mide el coste por topic recibido, con
+ *	topics repartidos uniformemente entre los tokens registrados y con topics no registrados (la tabla solo
+ *	recurre a isTopicToken sobre los tokens con comodines, ninguno en este caso).
+ *
+ *	Uso: bench_topics [busquedas por medida]
+ */
+
+#include "BenchModule.h"
+#include "TopicMap.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint16_t Sizes[] = { 5, 20, 100 };
+static const char* Base = "dev/0001/bench";
+
+
+/** Cadena isTopicToken: indice del primer token contenido en el topic */
+static int32_t chainFind(const char* topic, char (*tokens)[24], uint16_t count){
+	for(uint16_t i = 0; i < count; i++){
+		if(MQ::MQClient::isTopicToken(topic, tokens[i])){
+			return i;
+		}
+	}
+	return -1;
+}
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	uint32_t lookups = (argc > 1)? (uint32_t)atoi(argv[1]) : 1000000;
+	static char tokens[100][24];
+	static char topics[100][48];
+	char miss[48];
+	snprintf(miss, sizeof(miss), "%s/unknown/cmd", Base);
+	for(uint16_t i = 0; i < 100; i++){
+		snprintf(tokens[i], sizeof(tokens[i]), "/param%03u/set", i);
+		snprintf(topics[i], sizeof(topics[i]), "%s/param%03u/set", Base, i);
+	}
+
+	printf("\n== Resolucion de topics suscritos\n%-28s %12s %12s %12s %12s\n", "", "chain(ns)", "map(ns)", "miss chain", "miss map");
+	volatile int32_t sink = 0;
+	for(uint8_t s = 0; s < sizeof(Sizes) / sizeof(Sizes[0]); s++){
+		uint16_t n = Sizes[s];
+		TopicMap map(n);
+		for(uint16_t i = 0; i < n; i++){
+			map.add(tokens[i], MQ::SubscribeCallback());
+		}
+		// comprobacion: ambos metodos resuelven igual
+		for(uint16_t i = 0; i < n; i++){
+			MBED_ASSERT(map.find(topics[i], Base) == chainFind(topics[i], tokens, n));
+		}
+		double ns[4];
+		for(uint8_t m = 0; m < 4; m++){
+			uint64_t t0 = benchNow();
+			for(uint32_t k = 0; k < lookups; k++){
+				const char* topic = (m < 2)? topics[k % n] : miss;
+				sink = sink + ((m & 1)? map.find(topic, Base) : chainFind(topic, tokens, n));
+			}
+			ns[m] = (double)(benchNow() - t0) * 1000.0 / (double)lookups;
+		}
+		char label[32];
+		snprintf(label, sizeof(label), "%u topics", n);
+		printf("%-28s %12.1f %12.1f %12.1f %12.1f\n", label, ns[0], ns[1], ns[2], ns[3]);
+	}
+	return 0;
+}
+
+/**** END OF FILE ****/
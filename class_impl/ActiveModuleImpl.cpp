@@ -10,23 +10,57 @@
 //------------------------------------------------------------------------------------
 
 /** Print log macros
- *	Logger vlido (ej: _debug)
+ *	Trazas diferidas (DeferredLog): el thread del mdulo solo encola el formato y los argumentos, que se
+ *	formatean en el thread de volcado. Los argumentos '%s' deben ser cadenas persistentes o, si son transitorios
+ *	(p.ej. el topic recibido), pasarse con DeferredLog::copy para que se copien en la traza.
  */
 
 #define DEBUG_TRACE(format, ...)			\
 if(ActiveModule::_defdbg){					\
-	printf(format, ##__VA_ARGS__);			\
+	DeferredLog::log(DeferredLog::LevelInfo, NULL, format, ##__VA_ARGS__);	\
 }											\
  
+
+/** Esquema de la configuracin. Al aadir campos, se incrementa la versin del esquema y se indica en el campo
+ *  la versin en la que aparece, de forma que se migren las configuraciones grabadas. Las claves son locales al
+ *  mdulo (mximo 8 caracteres): la clave NV se forma anteponiendo el nombre del mdulo.
+ */
+const ActiveModuleImpl::Config ActiveModuleImpl::DefaultCfg = {
+	{0, 0, 0},		// color
+	50,				// speed
+};
+
+const ConfigField ActiveModuleImpl::CfgFields[] = {
+	CONFIG_ARRAY(Config, color, "Color", 0, 255, 1),
+	CONFIG_FIELD(Config, speed, "Speed", 0, 100, 1),
+};
+
+const ConfigSchema ActiveModuleImpl::CfgSchema = CONFIG_SCHEMA(Config, "Cfg", 1, CfgFields, DefaultCfg);
+
 //------------------------------------------------------------------------------------
 //-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
 //------------------------------------------------------------------------------------
 
 
 //------------------------------------------------------------------------------------
-ActiveModuleImpl::ActiveModuleImpl(FSManager* fs, bool defdbg) : ActiveModule("ActiveModuleImpl", osPriorityNormal, OS_STACK_SIZE, fs, defdbg) {
+ActiveModuleImpl::ActiveModuleImpl(FSManager* fs, bool defdbg) : ActiveModule("ActiveModuleImpl", osPriorityNormal, StackSize, fs, defdbg) {
 	_publicationCb = callback(this, &ActiveModuleImpl::publicationCb);
 	_subscriptionCb = callback(this, &ActiveModuleImpl::subscriptionCb);
+
+	// registra los topics a procesar (relativos al topic base de suscripcin) y sus manejadores
+	registerTopic("/which/event", callback(this, &ActiveModuleImpl::whichEventCb));
+
+	// gestor de bloques propio para los mensajes de la cola y sus datos asociados
+	static const MsgPool::SizeClass pool_classes[] = {
+		{MsgBlockSize, MaxQueueMessages},
+	};
+	setMsgPool(new MsgPool(pool_classes, sizeof(pool_classes)/sizeof(pool_classes[0])));
+
+	// limita la profundidad de la cola de la mquina de estados
+	setLaneDepth(LaneNormal, MaxQueueMessages);
+
+	// los topics base no se asignan aqu: liberan el arranque y el estado inicial podra ejecutarse antes de
+	// completar la construccin. Los asigna la aplicacin una vez construido el mdulo.
 }
 
 
@@ -37,39 +71,41 @@ ActiveModuleImpl::ActiveModuleImpl(FSManager* fs, bool defdbg) : ActiveModule("A
 
 //------------------------------------------------------------------------------------
 void ActiveModuleImpl::subscriptionCb(const char* topic, void* msg, uint16_t msg_len){
-    // procesa un evento, por ejemplo "xxx/which/event"
-    if(MQ::MQClient::isTopicToken(topic, "/which/event")){
-        DEBUG_TRACE("\r\nTemplImp\t Recibido topic %s", topic);
-
-        bool chk_ok = false;
-		/* Chequea que el mensaje tiene formato correcto */
-		//TODO
-		
-		if(!chk_ok){
-			DEBUG_TRACE("\r\nTemplImp\t ERR_MSG, mensaje con formato incorrecto en topic '%s'", topic);
-			return;
-		}
-				
-        // crea mensaje para publicar en la mquina de estados
-        State::Msg* op = (State::Msg*)Heap::memAlloc(sizeof(State::Msg));
-        MBED_ASSERT(op);
-		
-		/* Reserva espacio para alojar el mensaje y parsea el mensaje */
-		//TODO Heap::memAlloc(...);
-
-		/* Asigna el tipo de seal (evento) */
-		//TODO
-        op->sig = WhichEvt;
-		
-        /* Asigna el mensaje (anterior) o NULL si no se utiliza ninguno */
-		//TODO
-        op->msg = NULL;
-		
-        // postea en la cola de la mquina de estados
-        _queue.put(op);
+    // despacha el topic a su manejador registrado en el constructor
+    if(dispatchTopic(topic, msg, msg_len)){
         return;
     }
-    DEBUG_TRACE("\r\nTemplImp\t ERR_TOPIC. No se puede procesar el topic '%s'", topic);
+    DEBUG_TRACE("\r\nTemplImp\t ERR_TOPIC. No se puede procesar el topic '%s'", DeferredLog::copy(topic));
+}
+
+
+//------------------------------------------------------------------------------------
+void ActiveModuleImpl::whichEventCb(const char* topic, void* msg, uint16_t msg_len){
+    // procesa un evento, por ejemplo "xxx/which/event"
+    DEBUG_TRACE("\r\nTemplImp\t Recibido topic %s", DeferredLog::copy(topic));
+
+    bool chk_ok = false;
+	/* Chequea que el mensaje tiene formato correcto */
+	//TODO
+	
+	if(!chk_ok){
+		DEBUG_TRACE("\r\nTemplImp\t ERR_MSG, mensaje con formato incorrecto en topic '%s'", DeferredLog::copy(topic));
+		return;
+	}
+			
+    // crea mensaje para publicar en la mquina de estados. Un payload binario con el formato de los datos se entrega
+    // sin copia si es un RefBuffer publicado (publish), o se copia en los datos del mensaje en otro caso
+	/* Asigna el tipo de seal (evento) */
+	//TODO
+    State::Msg* op = newMessageRef(WhichEvt, msg, msg_len);
+    MBED_ASSERT(op);
+	
+	/* Si el mensaje requiere parseo, crea el mensaje con espacio para los datos y parsea directamente sobre ellos:
+	 *   State::Msg* op = newMessage(WhichEvt, sizeof(Config)); ...parseo sobre op->msg... */
+	//TODO
+	
+    // postea en la cola de la mquina de estados, en el carril de prioridad adecuado
+    putMessage(op, LaneNormal);
 }
 
 //------------------------------------------------------------------------------------
@@ -77,26 +113,21 @@ State::StateResult ActiveModuleImpl::Init_EventHandler(State::StateEvent* se){
 	State::Msg* st_msg = (State::Msg*)se->oe->value.p;
     switch((int)se->evt){
         case State::EV_ENTRY:{
-        	int err = osOK;
+        	// prepara los topics de publicacin una nica vez
+        	_which_topic = createPubTopic("which/topic");
         	DEBUG_TRACE("\r\nTemplImp\t Iniciando recuperacin de datos...");
-        	// recupera los datos de memoria NV
-        	err = _fs->restore("ActiveModuleImplCfg", &_cfg, sizeof(Config), NVSInterface::TypeBlob);
-        	if(err == osOK){
-            	// chequea la coherencia de los datos y en caso de algo no est bien, establece los datos por defecto
-            	// almacenndolos de nuevo en memoria NV.
-            	if(!checkIntegrity()){
-            		DEBUG_TRACE("\r\nTemplImp\t ERR_CFG. Ha fallado el check de integridad. Establece configuracin por defecto.");
-					setDefaultConfig();
-            	}
-				else{
-					DEBUG_TRACE("\r\nTemplImp\t Recuperacin de datos OK!");
-				}
+        	// recupera los datos de memoria NV, migrando versiones anteriores y reparando los campos incoherentes. En
+        	// caso de error establece los datos por defecto almacenndolos de nuevo en memoria NV.
+        	if(schemaRestore(CfgSchema, &_cfg)){
+				DEBUG_TRACE("\r\nTemplImp\t Recuperacin de datos OK!");
         	}
 			else{
-				DEBUG_TRACE("\r\nTemplImp\t ERR_FS. Error en la recuperacin de datos. Establece configuracin por defecto");
-				setDefaultConfig();
+				DEBUG_TRACE("\r\nTemplImp\t ERR_CFG. Error en la recuperacin de datos. Establece configuracin por defecto");
 			}
-        	
+
+        	/* Si es necesario, arma temporizadores diferidos o peridicos, que se reciben como una seal ms */
+        	//TODO: _timer_id = startTimer(TimerEvt, 1000, 1000);
+
             return State::HANDLED;
         }
 
@@ -107,30 +138,20 @@ State::StateResult ActiveModuleImpl::Init_EventHandler(State::StateEvent* se){
         // Procesa datos recibidos relativos al evento WhichEvt
         case WhichEvt:{
         	/* Recupera el mensaje */
-			//TODO var* data = (var*)(st_msg->msg);
+			//TODO var* data = getMsgData<var>(st_msg);
 
         	/* Si es necesario, almacena en el sistema de ficheros la configuracin o el parmetro correspondiente */
-			//TODO: _fs->save("TemplImplCfg", &_cfg.updFlagMask, sizeof(Config), NVSInterface::TypeBlob);
-			//TODO: _fs->saveParameter("TemplImplParam", &_cfg.param, sizeof(param), NVSInterface::TypeParam);
+			//TODO: saveConfig();	// graba nicamente los campos modificados
         	DEBUG_TRACE("\r\n[AstCal]\t TemplImp\t Datos actualizados");
 			
 			/* Si es necesario publica actualizacin en topic */
 			//TODO
-			char* pub_topic = (char*)Heap::memAlloc(MQ::MQClient::getMaxTopicLen());
-			MBED_ASSERT(pub_topic);
-			sprintf(pub_topic, "%s/which/topic", _pub_topic_base);
-			Data* pmsg = (Data*)Heap::memAlloc(sizeof(Data));
+			Data* pmsg = (Data*)RefBuffer::create(sizeof(Data));
 			MBED_ASSERT(pmsg);
 			memcpy(pmsg, &data_src, size);
-			MQ::MQClient::publish(pub_topic, pmsg, sizeof(Data), &_publicationCb);
-			Heap::memFree(pmsg);
-			Heap::memFree(pub_topic);
-			
-            // libera el mensaje (tanto el contenedor de datos como el propio mensaje)
-			if(st_msg->msg){
-				Heap::memFree(st_msg->msg);
-			}
-            Heap::memFree(st_msg);
+			publish(_which_topic, pmsg);
+
+            // el mensaje (y sus datos) se libera automticamente al finalizar el manejador
 			
 			/* Si es necesario cambia de estado */
 			//TODO
@@ -153,46 +174,30 @@ State::StateResult ActiveModuleImpl::Init_EventHandler(State::StateEvent* se){
 
 
 //------------------------------------------------------------------------------------
-void ActiveModuleImpl::putMessage(State::Msg *msg){
-    _queue.put(msg);
+void ActiveModuleImpl::publicationCb(const char* topic, int32_t result){
+
 }
 
 
 //------------------------------------------------------------------------------------
-osEvent ActiveModuleImpl:: getOsEvent(){
-	return _queue.get();
+bool ActiveModuleImpl::checkIntegrity(){
+	return schemaCheckIntegrity(CfgSchema, &_cfg);
 }
 
 
-
 //------------------------------------------------------------------------------------
-void ActiveModuleImpl::publicationCb(const char* topic, int32_t result){
-
+void ActiveModuleImpl::setDefaultConfig(){
+	schemaSetDefaults(CfgSchema, &_cfg);
 }
 
 
 //------------------------------------------------------------------------------------
-bool ActiveModuleImpl::checkIntegrity(){
-	bool chk_ok = true;
-	/* Chequea integridad de la configuracin */
-	// TODO
-	
-	if(!chk_ok){
-		setDefaultConfig();
-		return false;
-	}	
-	return true;
+void ActiveModuleImpl::restoreConfig(){
+	schemaRestore(CfgSchema, &_cfg);
 }
 
 
 //------------------------------------------------------------------------------------
-void ActiveModuleImpl::setDefaultConfig(){
-	/* Establece configuracin por defecto */
-	//TODO
-	
-	/* Guarda en memoria NV */
-	//TODO
-	_fs->save("TemplImplCfg", &_cfg, sizeof(Config), NVSInterface::TypeBlob);
-	_fs->saveParameter("TemplImplParam", &_cfg.param, sizeof(Param), NVSInterface::TypeParam);
+void ActiveModuleImpl::saveConfig(){
+	schemaSave(CfgSchema, &_cfg);
 }
-
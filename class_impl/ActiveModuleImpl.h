@@ -15,7 +15,8 @@
 class ActiveModuleImpl : public ActiveModule {
   public:
               
-    /** Constructor por defecto
+    /** Constructor por defecto. Los topics base (setPublicationBase, setSubscriptionBase) se asignan tras la
+     *  construccin, ya que liberan el arranque del mdulo.
      * 	@param fs Objeto FSManager para operaciones de backup
      * 	@param defdbg Flag para habilitar depuracin por defecto
      */
@@ -32,15 +33,16 @@ class ActiveModuleImpl : public ActiveModule {
     static const uint32_t MaxQueueMessages = 16;
 
 
+    /** Tamao de la pila del thread asociado (ver exportMemoryReport y build_impl.py -r) */
+    static const uint32_t StackSize = OS_STACK_SIZE;
+
+
     /** Flags de operaciones a realizar por la tarea */
     enum MsgEventFlags{
     	WhichEvt = (State::EV_RESERVED_USER << 0),  /// Flag inicial
 		/* Aadir otros aqu */
     };
 
-    /** Cola de mensajes de la mquina de estados */
-    Queue<State::Msg, MaxQueueMessages> _queue;
-
     /** Datos de configuracin */
 	struct Config {
 		uint8_t color[3];	// Color RGB
@@ -48,17 +50,13 @@ class ActiveModuleImpl : public ActiveModule {
 	};
 	Config _cfg;
 
+    /** Esquema de la configuracin (campos, rangos y versin) y configuracin por defecto */
+	static const Config DefaultCfg;
+	static const ConfigField CfgFields[];
+	static const ConfigSchema CfgSchema;
 
-    /** Interfaz para postear un mensaje de la mquina de estados en el Mailbox de la clase heredera
-     *  @param msg Mensaje a postear
-     */
-    virtual void putMessage(State::Msg *msg);
-
-
-    /** Interfaz para obtener un evento osEvent de la clase heredera
-     *  @param msg Mensaje a postear
-     */
-    virtual osEvent getOsEvent();
+    /** Topics de publicacin preformateados */
+	TopicHandle _which_topic;
 
 
  	/** Interfaz para manejar los eventos en la mquina de estados por defecto
@@ -76,6 +74,14 @@ class ActiveModuleImpl : public ActiveModule {
     virtual void subscriptionCb(const char* topic, void* msg, uint16_t msg_len);
 
 
+ 	/** Manejador del topic "/which/event" registrado mediante registerTopic
+      *  @param topic Identificador del topic
+      *  @param msg Mensaje recibido
+      *  @param msg_len Tamao del mensaje
+      */
+    void whichEventCb(const char* topic, void* msg, uint16_t msg_len);
+
+
  	/** Callback invocada al finalizar una publicacin local
       *  @param topic Identificador del topic
       *  @param result Resultado de la publicacin
@@ -94,6 +100,16 @@ class ActiveModuleImpl : public ActiveModule {
 	 */
 	void setDefaultConfig();
 
+
+   	/** Recupera la configuracin de memoria NV
+	 */
+	void restoreConfig();
+
+
+   	/** Graba en memoria NV los campos de la configuracin que han cambiado
+	 */
+	void saveConfig();
+
 };
      
 #endif /*__ActiveModuleImpl__H */
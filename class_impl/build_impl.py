@@ -1,5 +1,34 @@
 #!/usr/bin/env python
-import fileinput, sys, getopt, os
+import fileinput, sys, getopt, os, re, json
+import build_spec
+
+
+# margen sobre los maximos medidos al dimensionar desde un informe de consumo
+REPORT_MARGIN = 1.25
+
+
+def load_report(report, name):
+  ''' Busca en un informe de consumo (lineas JSON de ActiveModule::exportMemoryReport) la entrada del modulo.
+      El nombre exportado puede estar truncado a la longitud maxima del nombre del modulo. '''
+  for line in open(report):
+    line = line.strip()
+    if not line.startswith('{'):
+      continue
+    entry = json.loads(line)
+    module = entry.get('module', '')
+    if module and (module == name or name.startswith(module)):
+      return entry
+  return None
+
+
+def apply_report(s, entry):
+  ''' Sustituye las constantes de dimensionado del modulo con los maximos medidos mas un margen '''
+  if entry.get('stack_max', 0) > 0:
+    stack = int(entry['stack_max'] * REPORT_MARGIN + 255) // 256 * 256
+    s = re.sub(r'StackSize = \w+;', 'StackSize = %d;' % stack, s)
+  queue = max(2, int(entry.get('queue_max', 0) * REPORT_MARGIN + 0.999))
+  s = re.sub(r'MaxQueueMessages = \d+;', 'MaxQueueMessages = %d;' % queue, s)
+  return s
 
 
 if __name__ == '__main__':
@@ -8,33 +37,54 @@ if __name__ == '__main__':
   argv = sys.argv[1:]
 
   try:
-      opts, args = getopt.getopt(argv,"hn:p:", ["name=", "path="])
+      opts, args = getopt.getopt(argv,"hn:p:r:s:", ["name=", "path=", "report=", "spec="])
   except getopt.GetoptError:
-      print('build_impl.py -h -n <class_name> -p <output_path>')
+      print('build_impl.py -h -n <class_name> -p <output_path> [-r <memory_report>] [-s <module_spec>]')
       sys.exit(2)
   finally:
       pass
 
   filename = ''
   filepath = ''
+  report = ''
+  spec = None
 
   for opt, arg in opts:
       if opt in("-n", "--name"):
           filename = arg  
       elif opt in("-p", "--path"):
           filepath = arg
+      elif opt in("-r", "--report"):
+          report = arg
+      elif opt in("-s", "--spec"):
+          spec = build_spec.load(arg)
       else:
-        print('build_impl.py -h -n <class_name> -p <output_path>')
+        print('build_impl.py -h -n <class_name> -p <output_path> [-r <memory_report>] [-s <module_spec>]')
         sys.exit(2)
 
   currfile = os.getcwd() + '\ActiveModuleImpl'
 
+  generated = None
+  if spec is not None:
+    if not filename:
+      filename = spec['name']
+    print('Generating module from spec: ', filename)
+    generated = build_spec.generate(spec, filename)
+
+  entry = None
+  if report:
+    print('Reading memory report: ', report)
+    entry = load_report(report, filename)
+    if entry is None:
+      print('Module not found in report, keeping default sizes: ', filename)
+
   extensions = ['.h', '.cpp']
   for e in extensions:
     try:
       f_in = currfile + e
       f_out = filepath+'\\' + filename + '\\' + filename + e
-      print('Opening input file: ',f_in)
+      if generated is None:
+        print('Opening input file: ',f_in)
       print('Opening output file: ',f_out)
       
       # check if out_dir exists, else it creates it
@@ -46,11 +96,17 @@ if __name__ == '__main__':
           print('Error creating folder: ', out_dir)
           sys.exit(2)
 
-      # open input file
-      s = open(f_in).read()
-      print('Replacing text "ActiveModuleImpl" with text: ', filename)
-      # replace text
-      s = s.replace('ActiveModuleImpl', filename)
+      if generated is not None:
+        s = generated[e]
+      else:
+        # open input file
+        s = open(f_in).read()
+        print('Replacing text "ActiveModuleImpl" with text: ', filename)
+        # replace text
+        s = s.replace('ActiveModuleImpl', filename)
+      if entry is not None:
+        print('Sizing stack and queue from report: ', entry)
+        s = apply_report(s, entry)
       print('Saving changes to file: ', f_out)
       # save changes to output file
       f = open(f_out, 'w')
@@ -0,0 +1,324 @@
+#!/usr/bin/env python
+''' Generador de modulos ActiveModule a partir de una especificacion declarativa (JSON). Utilizado por
+    build_impl.py -s <spec>. Ver ActiveModuleImpl.json como ejemplo de especificacion. Invocado directamente
+    (build_spec.py <spec> <class_name> <output_path>) genera los ficheros en output_path; la compilacion de host
+    lo utiliza para comprobar que el modulo generado compila e instancia (ver spec_check.cpp).
+
+    El modulo generado parte del camino rapido:
+    - topics suscritos registrados en la tabla hash (registerTopic) con un decodificador por topic que valida el
+      tamano del payload y lo copia en un mensaje gestionado del pool del modulo, sin reservas adicionales
+    - tabla de despacho senal -> manejador constexpr, indexada por la posicion del bit de la senal
+    - topics de publicacion preformateados (TopicHandle)
+    - cola y pool de mensajes dimensionados segun la especificacion
+    - configuracion con esquema versionado (ConfigSchema)
+'''
+import json, os, sys
+
+
+# tamano y alineamiento de los tipos basicos admitidos en los payloads
+TYPE_SIZES = {
+  'bool': 1, 'char': 1, 'int8_t': 1, 'uint8_t': 1,
+  'int16_t': 2, 'uint16_t': 2,
+  'int32_t': 4, 'uint32_t': 4, 'float': 4,
+  'int64_t': 8, 'uint64_t': 8, 'double': 8,
+}
+
+# tamano de los datos alojados dentro del bloque de mensaje (ACTIVEMODULE_INLINE_PAYLOAD por defecto)
+INLINE_PAYLOAD = 32
+
+# maximo numero de senales (ActiveModule::MaxUserSignals, comprobado tambien en el modulo generado)
+MAX_SIGNALS = 29
+
+# longitud maxima de las claves locales de la configuracion (ConfigSchema::MaxFieldKeyLength)
+MAX_FIELD_KEY = 8
+
+
+def load(path):
+  ''' Carga una especificacion '''
+  return json.load(open(path))
+
+
+def field_count(f):
+  ''' Obtiene el numero de elementos de un campo [nombre, tipo, elementos, descripcion] '''
+  return f[2] if len(f) > 2 else 1
+
+
+def struct_size(fields):
+  ''' Calcula el tamano de una estructura con alineamiento natural. Solo se admiten los tipos de TYPE_SIZES '''
+  size = 0
+  align = 1
+  for f in fields:
+    if f[1] not in TYPE_SIZES:
+      raise ValueError('Tipo %s no admitido en el campo %s (tipos: %s)' % (f[1], f[0], ', '.join(sorted(TYPE_SIZES))))
+    t = TYPE_SIZES[f[1]]
+    count = field_count(f)
+    size = (size + t - 1) // t * t + t * count
+    align = max(align, t)
+  return (size + align - 1) // align * align
+
+
+def gen_struct(name, fields, comment):
+  ''' Genera la declaracion de una estructura de datos '''
+  s = '    /** %s */\n' % comment
+  s += '    struct %s {\n' % name
+  for f in fields:
+    decl = '%s %s%s;' % (f[1], f[0], '[%d]' % field_count(f) if field_count(f) > 1 else '')
+    s += '    \t%-39s/// %s\n' % (decl, f[3] if len(f) > 3 else f[0])
+  s += '    };\n'
+  return s
+
+
+def handler_name(topic):
+  ''' Obtiene el nombre del manejador de un topic, ej. "/speed/set" -> "speedSetCb" '''
+  parts = [p for p in topic.replace('+', 'any').replace('#', 'all').split('/') if p]
+  name = parts[0] + ''.join(p[:1].upper() + p[1:] for p in parts[1:])
+  return name + 'Cb'
+
+
+def generate(spec, name):
+  ''' Genera el contenido de los ficheros .h y .cpp del modulo
+      @param spec Especificacion
+      @param name Nombre de la clase
+      @return Diccionario {extension: contenido}
+  '''
+  structs = spec.get('structs', {})
+  signals = spec.get('signals', [])
+  states = spec.get('states', ['Init'])
+  subs = spec.get('topics', {}).get('sub', [])
+  pubs = spec.get('topics', {}).get('pub', [])
+  cfg = spec.get('config')
+  queue_depth = spec.get('queue_depth', 16)
+  stack_size = spec.get('stack_size', 'OS_STACK_SIZE')
+  priority = spec.get('priority', 'osPriorityNormal')
+  sig_by_name = dict((sg['name'], sg) for sg in signals)
+  if len(signals) > MAX_SIGNALS:
+    raise ValueError('Demasiadas senales (max %d)' % MAX_SIGNALS)
+  if states[0] != 'Init':
+    raise ValueError('El primer estado debe ser Init')
+  for sname in structs:
+    struct_size(structs[sname])
+
+  # payload de mayor tamano que no cabe dentro del bloque de mensaje
+  big = None
+  for sg in signals:
+    p = sg.get('payload')
+    if p and struct_size(structs[p]) > INLINE_PAYLOAD and (big is None or struct_size(structs[p]) > struct_size(structs[big])):
+      big = p
+
+  # ---- cabecera ----
+  h = '/*\n * %s.h\n *\n *\t%s is a class derived from ActiveModule, generated by build_impl.py from a spec\n */\n \n' % (name, name)
+  h += '#ifndef __%s__H\n#define __%s__H\n\n#include "mbed.h"\n#include "ActiveModule.h"\n\n\n   \n' % (name, name)
+  h += 'class %s : public ActiveModule {\n  public:\n              \n' % name
+  h += '    /** Constructor por defecto. Los topics base (setPublicationBase, setSubscriptionBase) se asignan tras la\n'
+  h += '     *  construccion, ya que liberan el arranque del modulo.\n     * \t@param fs Objeto FSManager para operaciones de backup\n'
+  h += '     * \t@param defdbg Flag para habilitar depuracion por defecto\n     */\n'
+  h += '    %s(FSManager* fs, bool defdbg = false);\n\n\n' % name
+  h += '    /** Destructor\n     */\n    virtual ~%s(){}\n\n' % name
+  for sname in sorted(structs):
+    if cfg and sname == cfg['struct']:
+      continue
+    h += '\n' + gen_struct(sname, structs[sname], 'Datos de las senales y topics %s' % sname) + '\n'
+  h += '  protected:\n\n'
+  h += '    /** Maximo numero de mensajes alojables en la cola asociada a la maquina de estados */\n'
+  h += '    static const uint32_t MaxQueueMessages = %d;\n\n\n' % queue_depth
+  h += '    /** Tamano de la pila del thread asociado (ver exportMemoryReport y build_impl.py -r) */\n'
+  h += '    static const uint32_t StackSize = %s;\n\n\n' % stack_size
+  h += '    /** Flags de operaciones a realizar por la tarea */\n    enum MsgEventFlags{\n'
+  for i, sg in enumerate(signals):
+    h += '    \t%-40s/// %s\n' % ('%s = (State::EV_RESERVED_USER << %d),' % (sg['name'], i), sg.get('doc', sg['name']))
+  h += '    };\n\n'
+  h += '    /** Numero de senales de la tabla de despacho */\n    static const uint8_t NumSignals = %d;\n' % len(signals)
+  h += '    static_assert(NumSignals <= MaxUserSignals, "Demasiadas senales (ActiveModule::MaxUserSignals)");\n\n'
+  if cfg:
+    h += gen_struct(cfg['struct'], structs[cfg['struct']], 'Datos de configuracion') + '\n'
+    h += '    %s _cfg;\n\n' % cfg['struct']
+    h += '    /** Esquema de la configuracion (campos, rangos y version) y configuracion por defecto */\n'
+    h += '    static const %s DefaultCfg;\n    static const ConfigField CfgFields[];\n    static const ConfigSchema CfgSchema;\n\n' % cfg['struct']
+  if pubs:
+    h += '    /** Topics de publicacion preformateados */\n'
+    for p in pubs:
+      h += '    TopicHandle _%s_topic;\n' % p['name']
+    h += '\n'
+  if len(states) > 1:
+    h += '    /** Estados adicionales de la maquina de estados */\n'
+    for st in states[1:]:
+      h += '    State _st%s;\n' % st
+    h += '\n'
+  for st in states:
+    h += ' \t/** Interfaz para manejar los eventos en el estado %s\n' % st
+    h += '      *  @param se Evento a manejar\n      *  @return State::StateResult Resultado del manejo del evento\n      */\n'
+    h += '    %sState::StateResult %s_EventHandler(State::StateEvent* se);\n\n\n' % ('virtual ' if st == 'Init' else '', st)
+  for sg in signals:
+    h += ' \t/** Manejador de la senal %s\n      *  @param msg Mensaje%s\n      *  @return State::StateResult Resultado del manejo\n      */\n' % (sg['name'], ' (datos %s)' % sg['payload'] if sg.get('payload') else '')
+    h += '    State::StateResult on%s(State::Msg* msg);\n\n\n' % sg['name']
+  h += '    /** Manejador de una senal */\n    typedef State::StateResult (%s::*SignalHandler)(State::Msg* msg);\n\n' % name
+  h += '    /** Tabla de despacho senal -> manejador, indexada por la posicion del bit de la senal */\n'
+  h += '    static constexpr SignalHandler SignalTable[NumSignals? NumSignals : 1] = {\n'
+  for sg in signals:
+    h += '    \t&%s::on%s,\n' % (name, sg['name'])
+  if not signals:
+    h += '    \tnullptr,\n'
+  h += '    };\n\n\n'
+  h += ' \t/** Callback invocada al recibir una actualizacion de un topic local al que esta suscrito\n'
+  h += '      *  @param topic Identificador del topic\n      *  @param msg Mensaje recibido\n      *  @param msg_len Tamano del mensaje\n      */\n'
+  h += '    virtual void subscriptionCb(const char* topic, void* msg, uint16_t msg_len);\n\n\n'
+  for t in subs:
+    h += ' \t/** Decodificador del topic "%s" registrado mediante registerTopic\n' % t['topic']
+    h += '      *  @param topic Identificador del topic\n      *  @param msg Mensaje recibido\n      *  @param msg_len Tamano del mensaje\n      */\n'
+    h += '    void %s(const char* topic, void* msg, uint16_t msg_len);\n\n\n' % handler_name(t['topic'])
+  h += ' \t/** Callback invocada al finalizar una publicacion local\n      *  @param topic Identificador del topic\n'
+  h += '      *  @param result Resultado de la publicacion\n      */\n'
+  h += '    virtual void publicationCb(const char* topic, int32_t result);\n\n\n'
+  h += ' \t/** Despacha una senal a su manejador de SignalTable\n      *  @param se Evento\n'
+  h += '      *  @return Resultado del manejador o State::IGNORED si la senal no esta en la tabla\n      */\n'
+  h += '    State::StateResult dispatchSignal(State::StateEvent* se){\n'
+  h += '    \tuint32_t evt = (uint32_t)se->evt;\n'
+  h += '    \tif(evt < (uint32_t)State::EV_RESERVED_USER){\n    \t\treturn State::IGNORED;\n    \t}\n'
+  h += '    \tuint32_t idx = __builtin_ctz(evt) - __builtin_ctz((uint32_t)State::EV_RESERVED_USER);\n'
+  h += '    \tif(idx >= NumSignals || !SignalTable[idx]){\n    \t\treturn State::IGNORED;\n    \t}\n'
+  h += '    \treturn (this->*SignalTable[idx])((State::Msg*)se->oe->value.p);\n    }\n'
+  # interfaz de configuracion de ActiveModule, sobre el esquema o vacia si el modulo no tiene configuracion
+  h += '\n\n   \t/** Chequea la integridad de los datos de configuracion%s. En caso de que algo no sea\n' % (' <_cfg>' if cfg else '')
+  h += '   \t * \tcoherente, restaura a los valores por defecto y graba en memoria NV.\n'
+  h += '   \t * \t@return True si la integridad es correcta, False si es incorrecta\n\t */\n\tbool checkIntegrity();\n\n\n'
+  h += '   \t/** Establece la configuracion por defecto grabandola en memoria NV\n\t */\n\tvoid setDefaultConfig();\n\n\n'
+  h += '   \t/** Recupera la configuracion de memoria NV\n\t */\n\tvoid restoreConfig();\n\n\n'
+  h += '   \t/** Graba en memoria NV los campos de la configuracion que han cambiado\n\t */\n\tvoid saveConfig();\n'
+  h += '\n};\n     \n#endif /*__%s__H */\n\n/**** END OF FILE ****/\n' % name
+
+  # ---- implementacion ----
+  c = '/*\n * %s.cpp\n *\n */\n\n#include "%s.h"\n\n' % (name, name)
+  c += '//------------------------------------------------------------------------------------\n'
+  c += '//-- PRIVATE TYPEDEFS ----------------------------------------------------------------\n'
+  c += '//------------------------------------------------------------------------------------\n\n'
+  c += '/** Print log macros\n *\tTrazas diferidas (DeferredLog): los argumentos \'%s\' deben ser cadenas persistentes o, si son\n *\ttransitorios (p.ej. el topic recibido), pasarse con DeferredLog::copy para que se copien en la traza.\n */\n\n'
+  c += '#define DEBUG_TRACE(format, ...)\t\t\t\\\nif(ActiveModule::_defdbg){\t\t\t\t\t\\\n'
+  c += '\tDeferredLog::log(DeferredLog::LevelInfo, NULL, format, ##__VA_ARGS__);\t\\\n}\t\t\t\t\t\t\t\t\t\t\t\\\n \n\n'
+  c += 'constexpr %s::SignalHandler %s::SignalTable[];\n\n' % (name, name)
+  if cfg:
+    cs = cfg['struct']
+    for k in [cfg.get('key', 'Cfg')] + [f['key'] for f in cfg['fields']]:
+      if len(k) > MAX_FIELD_KEY:
+        raise ValueError('Clave de configuracion %s demasiado larga (max %d)' % (k, MAX_FIELD_KEY))
+    c += '/** Esquema de la configuracion. Al anadir campos, se incrementa la version del esquema y se indica en el campo\n'
+    c += ' *  la version en la que aparece, de forma que se migren las configuraciones grabadas. Las claves son locales al\n'
+    c += ' *  modulo (maximo 8 caracteres): la clave NV se forma anteponiendo el nombre del modulo.\n */\n'
+    c += 'const %s::%s %s::DefaultCfg = {\n' % (name, cs, name)
+    for f in cfg['fields']:
+      d = f.get('default', 0)
+      d = '{%s}' % ', '.join(str(x) for x in d) if isinstance(d, list) else str(d)
+      c += '\t%s,\t\t// %s\n' % (d, f['name'])
+    c += '};\n\nconst ConfigField %s::CfgFields[] = {\n' % name
+    fields = dict((f[0], f) for f in structs[cs])
+    for f in cfg['fields']:
+      macro = 'CONFIG_ARRAY' if field_count(fields[f['name']]) > 1 else 'CONFIG_FIELD'
+      c += '\t%s(%s, %s, "%s", %s, %s, %d),\n' % (macro, cs, f['name'], f['key'], f.get('min', 0), f.get('max', 0), f.get('since', 1))
+    c += '};\n\n'
+    c += 'const ConfigSchema %s::CfgSchema = CONFIG_SCHEMA(%s, "%s", %d, CfgFields, DefaultCfg);\n\n' % (name, cs, cfg.get('key', 'Cfg'), cfg.get('version', 1))
+  c += '//------------------------------------------------------------------------------------\n'
+  c += '//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------\n'
+  c += '//------------------------------------------------------------------------------------\n\n\n'
+  c += '//------------------------------------------------------------------------------------\n'
+  c += '%s::%s(FSManager* fs, bool defdbg) : ActiveModule("%s", %s, StackSize, fs, defdbg) {\n' % (name, name, name, priority)
+  c += '\t_publicationCb = callback(this, &%s::publicationCb);\n' % name
+  c += '\t_subscriptionCb = callback(this, &%s::subscriptionCb);\n\n' % name
+  for st in states[1:]:
+    c += '\t_st%s.setHandler(callback(this, &%s::%s_EventHandler));\n' % (st, name, st)
+  if len(states) > 1:
+    c += '\n'
+  if subs:
+    c += '\t// registra los topics a procesar (relativos al topic base de suscripcion) y sus decodificadores\n'
+    for t in subs:
+      c += '\tregisterTopic("%s", callback(this, &%s::%s));\n' % (t['topic'], name, handler_name(t['topic']))
+    c += '\n'
+  c += '\t// gestor de bloques propio para los mensajes de la cola y sus datos asociados\n'
+  if big:
+    c += '\t// los datos que caben en un bloque de mensaje se alojan en la primera clase, dimensionada para ambos\n'
+    c += '\tstatic const bool BigPayload = (sizeof(%s) > MsgBlockSize);\n' % big
+    c += '\tstatic const MsgPool::SizeClass pool_classes[] = {\n'
+    c += '\t\t{MsgBlockSize, (BigPayload)? MaxQueueMessages : 2 * MaxQueueMessages},\n'
+    c += '\t\t{sizeof(%s), MaxQueueMessages},\n\t};\n' % big
+    c += '\tsetMsgPool(new MsgPool(pool_classes, (BigPayload)? 2 : 1));\n\n'
+  else:
+    c += '\tstatic const MsgPool::SizeClass pool_classes[] = {\n\t\t{MsgBlockSize, MaxQueueMessages},\n\t};\n'
+    c += '\tsetMsgPool(new MsgPool(pool_classes, sizeof(pool_classes)/sizeof(pool_classes[0])));\n\n'
+  c += '\t// limita la profundidad de la cola de la maquina de estados\n'
+  c += '\tsetLaneDepth(LaneNormal, MaxQueueMessages);\n}\n\n\n'
+  c += '//------------------------------------------------------------------------------------\n'
+  c += '//-- PROTECTED METHODS IMPLEMENTATION ------------------------------------------------\n'
+  c += '//------------------------------------------------------------------------------------\n\n\n'
+  c += '//------------------------------------------------------------------------------------\n'
+  c += 'void %s::subscriptionCb(const char* topic, void* msg, uint16_t msg_len){\n' % name
+  c += '    // despacha el topic a su decodificador registrado en el constructor\n'
+  c += '    if(dispatchTopic(topic, msg, msg_len)){\n        return;\n    }\n'
+  c += '    DEBUG_TRACE("\\r\\n%s\\t ERR_TOPIC. No se puede procesar el topic \'%%s\'", DeferredLog::copy(topic));\n}\n\n\n' % name
+  for t in subs:
+    sg = sig_by_name[t['signal']]
+    p = sg.get('payload')
+    lane = sg.get('lane', 'LaneNormal')
+    c += '//------------------------------------------------------------------------------------\n'
+    c += 'void %s::%s(const char* topic, void* msg, uint16_t msg_len){\n' % (name, handler_name(t['topic']))
+    if p:
+      c += '    // entrega el payload binario sin copia si es un RefBuffer publicado (publish), o lo copia en los datos del mensaje\n'
+      c += '    if(msg_len != sizeof(%s)){\n' % p
+      c += '        DEBUG_TRACE("\\r\\n%s\\t ERR_MSG, mensaje con formato incorrecto en topic \'%%s\'", DeferredLog::copy(topic));\n        return;\n    }\n' % name
+      c += '    State::Msg* op = newMessageRef(%s, msg, msg_len);\n' % sg['name']
+    else:
+      c += '    State::Msg* op = newMessage(%s);\n' % sg['name']
+    c += '    if(!op){\n        DEBUG_TRACE("\\r\\n%s\\t ERR_MSG, sin memoria para el topic \'%%s\'", DeferredLog::copy(topic));\n        return;\n    }\n' % name
+    c += '    putMessage(op, %s);\n}\n\n\n' % lane
+  for st in states:
+    c += '//------------------------------------------------------------------------------------\n'
+    c += 'State::StateResult %s::%s_EventHandler(State::StateEvent* se){\n' % (name, st)
+    c += '    switch((int)se->evt){\n        case State::EV_ENTRY:{\n'
+    if st == 'Init':
+      if pubs:
+        c += '        \t// prepara los topics de publicacion una unica vez\n'
+        for p in pubs:
+          c += '        \t_%s_topic = createPubTopic("%s");\n' % (p['name'], p['topic'])
+      if cfg:
+        c += '        \t// recupera los datos de memoria NV, migrando versiones anteriores y reparando los campos incoherentes\n'
+        c += '        \tif(!schemaRestore(CfgSchema, &_cfg)){\n'
+        c += '        \t\tDEBUG_TRACE("\\r\\n%s\\t ERR_CFG. Error en la recuperacion de datos. Establece configuracion por defecto");\n        \t}\n' % name
+      c += '        \t_ready = true;\n'
+    c += '            return State::HANDLED;\n        }\n\n'
+    c += '        case State::EV_EXIT:{\n            nextState();\n            return State::HANDLED;\n        }\n\n'
+    c += '        // las senales se despachan a su manejador de SignalTable\n'
+    c += '        default:{\n        \treturn dispatchSignal(se);\n        }\n\n     }\n}\n\n\n'
+  for sg in signals:
+    p = sg.get('payload')
+    c += '//------------------------------------------------------------------------------------\n'
+    c += 'State::StateResult %s::on%s(State::Msg* msg){\n' % (name, sg['name'])
+    if p:
+      c += '\t%s* data = getMsgData<%s>(msg);\n\tMBED_ASSERT(data);\n' % (p, p)
+    c += '\t// manejador sin implementar: se traza la senal no atendida\n'
+    c += '\tDEBUG_TRACE("\\r\\n%s\\t WARN_SIG. Senal %s sin implementar");\n\n' % (name, sg['name'])
+    c += '\t// el mensaje (y sus datos) se libera automaticamente al finalizar el manejador\n'
+    c += '\treturn State::IGNORED;\n}\n\n\n'
+  c += '//------------------------------------------------------------------------------------\n'
+  c += 'void %s::publicationCb(const char* topic, int32_t result){\n\n}\n' % name
+  sep = '\n\n//------------------------------------------------------------------------------------\n'
+  if cfg:
+    c += sep + 'bool %s::checkIntegrity(){\n\treturn schemaCheckIntegrity(CfgSchema, &_cfg);\n}\n' % name
+    c += sep + 'void %s::setDefaultConfig(){\n\tschemaSetDefaults(CfgSchema, &_cfg);\n}\n' % name
+    c += sep + 'void %s::restoreConfig(){\n\tschemaRestore(CfgSchema, &_cfg);\n}\n' % name
+    c += sep + 'void %s::saveConfig(){\n\tschemaSave(CfgSchema, &_cfg);\n}\n' % name
+  else:
+    c += sep + 'bool %s::checkIntegrity(){\n\t// modulo sin configuracion\n\treturn true;\n}\n' % name
+    c += sep + 'void %s::setDefaultConfig(){\n\n}\n' % name
+    c += sep + 'void %s::restoreConfig(){\n\n}\n' % name
+    c += sep + 'void %s::saveConfig(){\n\n}\n' % name
+  c += '\n'
+  return {'.h': h, '.cpp': c}
+
+
+if __name__ == '__main__':
+  if len(sys.argv) != 4:
+    print('build_spec.py <module_spec> <class_name> <output_path>')
+    sys.exit(2)
+  generated = generate(load(sys.argv[1]), sys.argv[2])
+  if not os.path.exists(sys.argv[3]):
+    os.makedirs(sys.argv[3])
+  for e in generated:
+    with open(os.path.join(sys.argv[3], sys.argv[2] + e), 'w') as f:
+      f.write(generated[e])
@@ -0,0 +1,69 @@
+/*
+ * spec_check.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Comprobacion de host del generador build_spec.py: la compilacion genera SpecModule desde ActiveModuleImpl.json
+ *	(modulo con configuracion) y SpecPlain desde spec_check.json (sin configuracion), los instancia sobre la
+ *	libreria de host y espera a que completen su estado inicial. Se ejecuta con ctest.
+ */
+
+#include "mbed.h"
+#include <stdlib.h>
+#include "SpecModule.h"
+#include "SpecPlain.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint32_t StartTimeoutMillis = 2000;
+
+
+/** Asigna los topics base de un modulo y espera a que complete su estado inicial
+ *  @return True si se ha iniciado en StartTimeoutMillis
+ */
+static bool bringUp(ActiveModule* module, const char* pub_base, const char* sub_base){
+	module->setPublicationBase(pub_base);
+	module->setSubscriptionBase(sub_base);
+	uint64_t deadline = Kernel::get_ms_count() + StartTimeoutMillis;
+	while(!module->ready() && Kernel::get_ms_count() < deadline){
+		Thread::wait(1);
+	}
+	return module->ready();
+}
+
+
+//------------------------------------------------------------------------------------
+int main(){
+	MQ::MQBroker::start();
+	// directorio NV vacio en cada ejecucion, de forma que el primer arranque grabe la configuracion por defecto
+	char dir[] = "/tmp/spec_checkXXXXXX";
+	if(!mkdtemp(dir)){
+		printf("ERROR: no se puede crear el directorio NV\n");
+		return 1;
+	}
+	FSManager fs("spec", dir);
+	int result = 0;
+
+	// modulo con configuracion: el primer arranque graba la configuracion por defecto
+	SpecModule* cfg_module = new SpecModule(&fs);
+	if(!bringUp(cfg_module, "stat/spec", "set/spec") || fs.writes() == 0){
+		printf("ERROR: SpecModule no iniciado o sin configuracion grabada\n");
+		result = 1;
+	}
+
+	// modulo sin configuracion
+	SpecPlain* plain = new SpecPlain(&fs);
+	if(!bringUp(plain, "stat/plain", "set/plain")){
+		printf("ERROR: SpecPlain no iniciado\n");
+		result = 1;
+	}
+	if(result == 0){
+		printf("OK: modulos generados iniciados\n");
+	}
+	return result;
+}
+
+/**** END OF FILE ****/
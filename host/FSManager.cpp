@@ -0,0 +1,96 @@
+/*
+ * FSManager.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "FSManager.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+FSManager::FSManager(const char* name, const char* dir){
+	snprintf(_name, sizeof(_name), "%s", name);
+	snprintf(_dir, sizeof(_dir), "%s", dir);
+	_writes = 0;
+}
+
+
+//------------------------------------------------------------------------------------
+bool FSManager::open(){
+	return (_mtx.lock() == osOK);
+}
+
+
+//------------------------------------------------------------------------------------
+void FSManager::close(){
+	_mtx.unlock();
+}
+
+
+//------------------------------------------------------------------------------------
+int FSManager::save(const char* key, void* data, size_t size, KeyValueType type){
+	char file[192];
+	if(!path(key, file, sizeof(file))){
+		return osErrorParameter;
+	}
+	FILE* f = fopen(file, "wb");
+	if(!f){
+		return osErrorResource;
+	}
+	uint8_t t = (uint8_t)type;
+	bool ok = (fwrite(&t, 1, 1, f) == 1 && fwrite(data, 1, size, f) == size);
+	ok = (fclose(f) == 0) && ok;
+	_writes++;
+	return (ok)? osOK : osErrorResource;
+}
+
+
+//------------------------------------------------------------------------------------
+int FSManager::restore(const char* key, void* data, size_t size, KeyValueType type){
+	char file[192];
+	if(!path(key, file, sizeof(file))){
+		return osErrorParameter;
+	}
+	FILE* f = fopen(file, "rb");
+	if(!f){
+		return osErrorResource;
+	}
+	uint8_t t = 0xFF;
+	bool ok = (fread(&t, 1, 1, f) == 1 && t == (uint8_t)type && fread(data, 1, size, f) == size && fgetc(f) == EOF);
+	fclose(f);
+	return (ok)? osOK : osErrorValue;
+}
+
+
+//------------------------------------------------------------------------------------
+int FSManager::removeKey(const char* key){
+	char file[192];
+	if(!path(key, file, sizeof(file))){
+		return osErrorParameter;
+	}
+	_writes++;
+	return (::remove(file) == 0)? osOK : osErrorResource;
+}
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE METHODS IMPLEMENTATION --------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+bool FSManager::path(const char* key, char* buf, size_t len){
+	// mismas restricciones de clave que NVS
+	if(!key || strlen(key) == 0 || strlen(key) > MaxKeyLength || strchr(key, '/')){
+		return false;
+	}
+	return ((size_t)snprintf(buf, len, "%s/%s.%s", _dir, _name, key) < len);
+}
+
+/**** END OF FILE ****/
@@ -0,0 +1,68 @@
+/*
+ * FSManager.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Adaptacion para el host del gestor de memoria NV: cada clave se guarda en un fichero "<dir>/<name>.<key>"
+ *	con el tipo y los datos. Las operaciones devuelven osOK o un codigo de error, como en el target.
+ */
+
+#ifndef __FSManager__H
+#define __FSManager__H
+
+#include "mbed.h"
+
+
+class NVSInterface {
+  public:
+	/** Tipos de los datos de cada clave */
+	enum KeyValueType {
+		TypeUint8 = 0,
+		TypeInt8,
+		TypeUint16,
+		TypeInt16,
+		TypeUint32,
+		TypeInt32,
+		TypeUint64,
+		TypeInt64,
+		TypeString,
+		TypeBlob,
+	};
+
+	/** Longitud maxima de una clave (NVS) */
+	static const uint8_t MaxKeyLength = 15;
+};
+
+
+class FSManager : public NVSInterface {
+  public:
+
+    /** Constructor
+     *  @param name Nombre del particionado (prefijo de los ficheros)
+     *  @param dir Directorio de los ficheros (debe existir)
+     */
+	FSManager(const char* name, const char* dir = ".");
+
+	bool open();
+	void close();
+	bool ready() { return true; }
+	int save(const char* key, void* data, size_t size, KeyValueType type);
+	int restore(const char* key, void* data, size_t size, KeyValueType type);
+	int removeKey(const char* key);
+
+	/** Numero de operaciones save/removeKey realizadas (escrituras en memoria NV) */
+	uint32_t writes() { return _writes; }
+
+  private:
+	char _name[16];
+	char _dir[128];
+	uint32_t _writes;
+	Mutex _mtx;
+
+	bool path(const char* key, char* buf, size_t len);
+};
+
+#endif /*__FSManager__H */
+
+/**** END OF FILE ****/
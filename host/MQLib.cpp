@@ -0,0 +1,121 @@
+/*
+ * MQLib.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "MQLib.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+Mutex MQ::MQBroker::_mtx;
+MQ::MQBroker::Subscription MQ::MQBroker::_subs[MQ::MQBroker::MaxSubscriptions];
+uint16_t MQ::MQBroker::_count = 0;
+uint16_t MQ::MQBroker::_max_len = 64;
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+int32_t MQ::MQClient::subscribe(const char* name, SubscribeCallback* cb){
+	if(!name || !cb){
+		return NULL_POINTER;
+	}
+	if(MQBroker::_mtx.lock(MQBroker::DefaultMutexTimeout) != osOK){
+		return NOT_ALLOWED;
+	}
+	int32_t result = OUT_OF_MEMORY;
+	if(MQBroker::_count < MQBroker::MaxSubscriptions){
+		MQBroker::Subscription& s = MQBroker::_subs[MQBroker::_count];
+		if((s.topic = (char*)malloc(strlen(name) + 1)) != NULL){
+			strcpy(s.topic, name);
+			s.cb = cb;
+			MQBroker::_count++;
+			result = SUCCESS;
+		}
+	}
+	MQBroker::_mtx.unlock();
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t MQ::MQClient::unsubscribe(const char* name, SubscribeCallback* cb){
+	if(MQBroker::_mtx.lock(MQBroker::DefaultMutexTimeout) != osOK){
+		return NOT_ALLOWED;
+	}
+	int32_t result = NOT_FOUND;
+	for(uint16_t i = 0; i < MQBroker::_count; i++){
+		MQBroker::Subscription& s = MQBroker::_subs[i];
+		if(s.cb == cb && strcmp(s.topic, name) == 0){
+			free(s.topic);
+			s = MQBroker::_subs[--MQBroker::_count];
+			result = SUCCESS;
+			break;
+		}
+	}
+	MQBroker::_mtx.unlock();
+	return result;
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t MQ::MQClient::publish(const char* name, void* data, uint32_t datasize, PublishCallback* publisher){
+	if(!name){
+		return NULL_POINTER;
+	}
+	if(strlen(name) > MQBroker::_max_len){
+		return NOT_ALLOWED;
+	}
+	// los suscriptores se invocan fuera del mutex, de forma que puedan publicar o suscribirse a su vez
+	SubscribeCallback* cbs[MQBroker::MaxSubscriptions];
+	uint16_t count = 0;
+	if(MQBroker::_mtx.lock(MQBroker::DefaultMutexTimeout) != osOK){
+		return NOT_ALLOWED;
+	}
+	for(uint16_t i = 0; i < MQBroker::_count; i++){
+		if(match(MQBroker::_subs[i].topic, name)){
+			cbs[count++] = MQBroker::_subs[i].cb;
+		}
+	}
+	MQBroker::_mtx.unlock();
+	for(uint16_t i = 0; i < count; i++){
+		cbs[i]->call(name, data, (uint16_t)datasize);
+	}
+	if(publisher && *publisher){
+		publisher->call(name, SUCCESS);
+	}
+	return SUCCESS;
+}
+
+
+//------------------------------------------------------------------------------------
+bool MQ::MQClient::match(const char* filter, const char* topic){
+	while(*filter){
+		if(*filter == '#'){
+			return true;
+		}
+		if(*filter == '+'){
+			// un nivel completo del topic
+			while(*topic && *topic != '/'){
+				topic++;
+			}
+			filter++;
+			continue;
+		}
+		if(*filter != *topic){
+			return false;
+		}
+		filter++;
+		topic++;
+	}
+	return (*topic == 0);
+}
+
+/**** END OF FILE ****/
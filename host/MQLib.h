@@ -0,0 +1,87 @@
+/*
+ * MQLib.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Adaptacion para el host de la libreria MQLib: broker en proceso con suscripciones por topic (comodines '+'
+ *	y '#'), publicacion sincrona en el thread del publicador y gestor de memoria Heap sobre malloc/free.
+ */
+
+#ifndef __MQLib__H
+#define __MQLib__H
+
+#include "mbed.h"
+
+
+class Heap {
+  public:
+	static void* memAlloc(size_t size) { return malloc(size); }
+	static void memFree(void* ptr) { free(ptr); }
+};
+
+
+namespace MQ {
+
+/** Resultados de las operaciones del broker */
+enum ErrorResult {
+	SUCCESS = 0,
+	NULL_POINTER,
+	OUT_OF_MEMORY,
+	NOT_ALLOWED,
+	NOT_FOUND,
+};
+
+typedef Callback<void(const char* name, void* msg, uint16_t msg_len)> SubscribeCallback;
+typedef Callback<void(const char* name, int32_t result)> PublishCallback;
+
+
+class MQBroker {
+  public:
+	/** Espera maxima de acceso al broker */
+	static const uint32_t DefaultMutexTimeout = 1000;
+
+	/** Maximo numero de suscripciones */
+	static const uint16_t MaxSubscriptions = 256;
+
+	static void start(uint16_t max_len = 64) { _max_len = max_len; }
+	static bool ready() { return true; }
+	static uint16_t getMaxTopicLen() { return _max_len; }
+
+  private:
+	friend class MQClient;
+
+	struct Subscription {
+		char* topic;
+		SubscribeCallback* cb;
+	};
+
+	static Mutex _mtx;
+	static Subscription _subs[MaxSubscriptions];
+	static uint16_t _count;
+	static uint16_t _max_len;
+};
+
+
+class MQClient {
+  public:
+	static int32_t subscribe(const char* name, SubscribeCallback* cb);
+	static int32_t unsubscribe(const char* name, SubscribeCallback* cb);
+
+	/** Publica unos datos: invoca a todos los suscriptores del topic y a continuacion al publicador */
+	static int32_t publish(const char* name, void* data, uint32_t datasize, PublishCallback* publisher);
+
+	/** Chequea si un topic contiene un token */
+	static bool isTopicToken(const char* topic, const char* token) { return (strstr(topic, token) != NULL); }
+
+	static uint16_t getMaxTopicLen() { return MQBroker::getMaxTopicLen(); }
+
+	/** Chequea si un topic encaja en un filtro de suscripcion con comodines */
+	static bool match(const char* filter, const char* topic);
+};
+
+}
+
+#endif /*__MQLib__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,82 @@
+/*
+ * StateMachine.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "StateMachine.h"
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+StateMachine::StateMachine(){
+	_msg_handler = NULL;
+	_curr = NULL;
+	_next = NULL;
+}
+
+
+//------------------------------------------------------------------------------------
+void StateMachine::initState(State* st){
+	_curr = st;
+	_next = NULL;
+	notify(_curr, State::EV_ENTRY, NULL);
+}
+
+
+//------------------------------------------------------------------------------------
+void StateMachine::tranState(State* st){
+	_next = st;
+	notify(_curr, State::EV_EXIT, NULL);
+}
+
+
+//------------------------------------------------------------------------------------
+void StateMachine::nextState(){
+	if(!_next){
+		return;
+	}
+	_curr = _next;
+	_next = NULL;
+	notify(_curr, State::EV_ENTRY, NULL);
+}
+
+
+//------------------------------------------------------------------------------------
+void StateMachine::run(osEvent* oe){
+	if(!_curr){
+		return;
+	}
+	if(oe->status == osEventMessage){
+		State::Msg* msg = (State::Msg*)oe->value.p;
+		notify(_curr, (State::EventType)msg->sig, oe);
+	}
+	else if(oe->status == osEventTimeout){
+		notify(_curr, State::EV_TIMED, oe);
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE METHODS IMPLEMENTATION --------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+void StateMachine::notify(State* st, State::EventType evt, osEvent* oe){
+	// los manejadores acceden siempre a se->oe->value.p
+	osEvent empty;
+	empty.status = osOK;
+	empty.value.p = NULL;
+	State::StateEvent se;
+	se.evt = evt;
+	se.oe = (oe)? oe : &empty;
+	st->handle(&se);
+}
+
+/**** END OF FILE ****/
@@ -0,0 +1,91 @@
+/*
+ * StateMachine.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Adaptacion para el host de la libreria StateMachine: estados con manejador de eventos, entrada inicial
+ *	(initState) y transiciones en dos pasos. tranState notifica EV_EXIT al estado actual, cuyo manejador invoca
+ *	nextState para entrar (EV_ENTRY) en el estado destino.
+ */
+
+#ifndef __StateMachine__H
+#define __StateMachine__H
+
+#include "mbed.h"
+
+
+class State {
+  public:
+
+	/** Eventos reservados. Las senales de usuario son EV_RESERVED_USER << i */
+	enum EventType {
+		EV_INVALID = 0,
+		EV_ENTRY = (1 << 0),
+		EV_EXIT = (1 << 1),
+		EV_TIMED = (1 << 2),
+		EV_RESERVED_USER = (1 << 3),
+	};
+
+	/** Resultado de un manejador */
+	enum StateResult {
+		HANDLED = 0,
+		IGNORED,
+		TRANSITION,
+	};
+
+	/** Mensaje entregado a la maquina de estados */
+	struct Msg {
+		uint32_t sig;
+		void* msg;
+	};
+
+	/** Evento entregado al manejador de un estado */
+	struct StateEvent {
+		EventType evt;
+		osEvent* oe;
+	};
+
+	State() {}
+
+	void setHandler(Callback<StateResult(StateEvent*)> handler) { _handler = handler; }
+
+	StateResult handle(StateEvent* se) { return (_handler)? _handler.call(se) : IGNORED; }
+
+  private:
+	Callback<StateResult(StateEvent*)> _handler;
+};
+
+
+class StateMachine {
+  public:
+	StateMachine();
+	virtual ~StateMachine() {}
+
+	/** Asigna el manejador con el que otros componentes postean mensajes en la maquina */
+	void attachMessageHandler(Callback<osStatus(State::Msg*)>* msg_handler) { _msg_handler = msg_handler; }
+
+	/** Establece el estado inicial y le notifica EV_ENTRY */
+	void initState(State* st);
+
+	/** Inicia una transicion: notifica EV_EXIT al estado actual */
+	void tranState(State* st);
+
+	/** Completa la transicion en curso: notifica EV_ENTRY al estado destino */
+	void nextState();
+
+	/** Entrega un evento (mensaje o vencimiento de la espera) al estado actual */
+	void run(osEvent* oe);
+
+  protected:
+	Callback<osStatus(State::Msg*)>* _msg_handler;
+	State* _curr;
+	State* _next;
+
+  private:
+	void notify(State* st, State::EventType evt, osEvent* oe);
+};
+
+#endif /*__StateMachine__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,320 @@
+/*
+ * mbed.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ */
+
+#include "mbed.h"
+#include <stdarg.h>
+#include <time.h>
+#include <errno.h>
+#include <sched.h>
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+/** Patron de marcado de las pilas para medir su uso maximo */
+static const uint8_t StackPattern = 0xE5;
+
+static pthread_mutex_t s_critical = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static pthread_mutex_t s_trace = PTHREAD_MUTEX_INITIALIZER;
+static __thread uint32_t s_isr_nesting = 0;
+
+
+/** Reloj monotono en microsegundos */
+static uint64_t us_monotonic(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static const uint64_t s_t0 = us_monotonic();
+
+
+//------------------------------------------------------------------------------------
+//-- PUBLIC METHODS IMPLEMENTATION ---------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+void mbed_assert_internal(const char* expr, const char* file, int line){
+	fprintf(stderr, "MBED_ASSERT failed: %s, file: %s, line %d\n", expr, file, line);
+	fflush(stderr);
+	abort();
+}
+
+
+//------------------------------------------------------------------------------------
+void host_trace(char level, const char* module, const char* fmt, ...){
+	va_list args;
+	va_start(args, fmt);
+	pthread_mutex_lock(&s_trace);
+	printf("[%c]%s ", level, (module)? module : "");
+	vprintf(fmt, args);
+	printf("\n");
+	pthread_mutex_unlock(&s_trace);
+	va_end(args);
+}
+
+
+//------------------------------------------------------------------------------------
+bool host_in_isr(){
+	return (s_isr_nesting > 0);
+}
+
+
+//------------------------------------------------------------------------------------
+HostIsrScope::HostIsrScope(){
+	s_isr_nesting++;
+}
+
+
+//------------------------------------------------------------------------------------
+HostIsrScope::~HostIsrScope(){
+	s_isr_nesting--;
+}
+
+
+//------------------------------------------------------------------------------------
+void core_util_critical_section_enter(){
+	pthread_mutex_lock(&s_critical);
+}
+
+
+//------------------------------------------------------------------------------------
+void core_util_critical_section_exit(){
+	pthread_mutex_unlock(&s_critical);
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t us_ticker_read(){
+	return (uint32_t)(us_monotonic() - s_t0);
+}
+
+
+//------------------------------------------------------------------------------------
+uint64_t Kernel::get_ms_count(){
+	return (us_monotonic() - s_t0) / 1000ULL;
+}
+
+
+//------------------------------------------------------------------------------------
+HostCond::HostCond(){
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&_cond, &attr);
+	pthread_condattr_destroy(&attr);
+	pthread_mutex_init(&_mtx, NULL);
+}
+
+
+//------------------------------------------------------------------------------------
+HostCond::~HostCond(){
+	// los objetos estaticos (p.ej. el semaforo de TimerService) se destruyen al salir del proceso con threads aun
+	// esperando en ellos, y pthread_cond_destroy esperaria indefinidamente a esos threads: no se destruyen
+}
+
+
+//------------------------------------------------------------------------------------
+bool HostCond::wait(uint64_t deadline_us){
+	if(deadline_us == 0){
+		pthread_cond_wait(&_cond, &_mtx);
+		return true;
+	}
+	struct timespec ts;
+	ts.tv_sec = deadline_us / 1000000ULL;
+	ts.tv_nsec = (deadline_us % 1000000ULL) * 1000ULL;
+	return (pthread_cond_timedwait(&_cond, &_mtx, &ts) != ETIMEDOUT);
+}
+
+
+//------------------------------------------------------------------------------------
+uint64_t HostCond::deadline(uint32_t millisec){
+	return (millisec == osWaitForever)? 0 : (us_monotonic() + (uint64_t)millisec * 1000ULL);
+}
+
+
+//------------------------------------------------------------------------------------
+Mutex::Mutex(){
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&_mtx, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+
+//------------------------------------------------------------------------------------
+Mutex::~Mutex(){
+	pthread_mutex_destroy(&_mtx);
+}
+
+
+//------------------------------------------------------------------------------------
+osStatus Mutex::lock(uint32_t millisec){
+	if(millisec == osWaitForever){
+		return (pthread_mutex_lock(&_mtx) == 0)? osOK : osErrorResource;
+	}
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	uint64_t ns = (uint64_t)ts.tv_nsec + (uint64_t)millisec * 1000000ULL;
+	ts.tv_sec += ns / 1000000000ULL;
+	ts.tv_nsec = ns % 1000000000ULL;
+	return (pthread_mutex_timedlock(&_mtx, &ts) == 0)? osOK : osErrorTimeout;
+}
+
+
+//------------------------------------------------------------------------------------
+bool Mutex::trylock(){
+	return (pthread_mutex_trylock(&_mtx) == 0);
+}
+
+
+//------------------------------------------------------------------------------------
+osStatus Mutex::unlock(){
+	return (pthread_mutex_unlock(&_mtx) == 0)? osOK : osErrorResource;
+}
+
+
+//------------------------------------------------------------------------------------
+Semaphore::Semaphore(int32_t count, uint16_t max_count){
+	_count = count;
+	_max = max_count;
+}
+
+
+//------------------------------------------------------------------------------------
+int32_t Semaphore::wait(uint32_t millisec){
+	uint64_t deadline = HostCond::deadline(millisec);
+	_cond.lock();
+	while(_count == 0){
+		if(millisec == 0 || !_cond.wait(deadline)){
+			_cond.unlock();
+			return 0;
+		}
+	}
+	int32_t tokens = _count--;
+	_cond.unlock();
+	return tokens;
+}
+
+
+//------------------------------------------------------------------------------------
+osStatus Semaphore::release(){
+	_cond.lock();
+	if(_count >= _max){
+		_cond.unlock();
+		return osErrorResource;
+	}
+	_count++;
+	_cond.broadcast();
+	_cond.unlock();
+	return osOK;
+}
+
+
+//------------------------------------------------------------------------------------
+Thread::Thread(osPriority priority, uint32_t stack_size, unsigned char* /*stack_mem*/, const char* name){
+	// la memoria de pila del target (stack_mem) no se utiliza: el host requiere pilas mayores
+	_priority = priority;
+	_stack_size = stack_size;
+	_name = name;
+	_host_stack_size = (stack_size > HOST_MIN_STACK_SIZE)? stack_size : HOST_MIN_STACK_SIZE;
+	_host_stack = NULL;
+	_started = false;
+}
+
+
+//------------------------------------------------------------------------------------
+Thread::~Thread(){
+	// la pila de un thread en ejecucion no puede liberarse
+	if(!_started){
+		free(_host_stack);
+	}
+}
+
+
+//------------------------------------------------------------------------------------
+osStatus Thread::start(Callback<void()> task){
+	if(_started){
+		return osErrorParameter;
+	}
+	if(posix_memalign((void**)&_host_stack, 64, _host_stack_size) != 0){
+		return osErrorNoMemory;
+	}
+	memset(_host_stack, StackPattern, _host_stack_size);
+	_task = task;
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstack(&attr, _host_stack, _host_stack_size);
+	int err = pthread_create(&_tid, &attr, &Thread::entry, this);
+	pthread_attr_destroy(&attr);
+	if(err != 0){
+		free(_host_stack);
+		_host_stack = NULL;
+		return osErrorResource;
+	}
+	_started = true;
+	return osOK;
+}
+
+
+//------------------------------------------------------------------------------------
+osStatus Thread::join(){
+	if(!_started || pthread_join(_tid, NULL) != 0){
+		return osErrorParameter;
+	}
+	_started = false;
+	return osOK;
+}
+
+
+//------------------------------------------------------------------------------------
+uint32_t Thread::max_stack(){
+	if(!_host_stack){
+		return 0;
+	}
+	// la pila crece hacia direcciones bajas: se cuentan los bytes sin utilizar desde el inicio
+	size_t untouched = 0;
+	while(untouched < _host_stack_size && _host_stack[untouched] == StackPattern){
+		untouched++;
+	}
+	return (uint32_t)(_host_stack_size - untouched);
+}
+
+
+//------------------------------------------------------------------------------------
+osStatus Thread::wait(uint32_t millisec){
+	struct timespec ts;
+	ts.tv_sec = millisec / 1000;
+	ts.tv_nsec = (millisec % 1000) * 1000000L;
+	while(nanosleep(&ts, &ts) != 0 && errno == EINTR);
+	return osEventTimeout;
+}
+
+
+//------------------------------------------------------------------------------------
+osStatus Thread::yield(){
+	sched_yield();
+	return osOK;
+}
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE METHODS IMPLEMENTATION --------------------------------------------------
+//------------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------------
+void* Thread::entry(void* arg){
+	Thread* th = (Thread*)arg;
+	th->_task.call();
+	return NULL;
+}
+
+/**** END OF FILE ****/
@@ -0,0 +1,343 @@
+/*
+ * mbed.h
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Adaptacion POSIX (pthreads) del subconjunto de la API de MBED utilizado por ActiveModule, para compilar y
+ *	perfilar los modulos en el host (ver CMakeLists.txt y bench/). No forma parte de la compilacion en MBED ni en
+ *	ESP-IDF (ver .mbedignore).
+ *
+ *	Diferencias con el target:
+ *	  - Las prioridades de los threads se ignoran (planificador del sistema operativo).
+ *	  - La pila de cada thread es como minimo HOST_MIN_STACK_SIZE. stack_size() devuelve el tamano solicitado y
+ *	    max_stack() el maximo utilizado en el host, medido por marcado de la pila.
+ *	  - Las secciones criticas se implementan con un mutex recursivo global.
+ *	  - IS_ISR() es cierto dentro de un ambito HostIsrScope, para simular contexto de interrupcion.
+ */
+
+#ifndef __mbed__H
+#define __mbed__H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <functional>
+
+/** Pila minima de los threads en el host (las pilas del target no bastan para la libc del host) */
+#ifndef HOST_MIN_STACK_SIZE
+#define HOST_MIN_STACK_SIZE		(256 * 1024)
+#endif
+
+#define OS_STACK_SIZE			4096
+#define osWaitForever			0xFFFFFFFFU
+
+#define MBED_ALIGN(N)			__attribute__((aligned(N)))
+#define MBED_ASSERT(_EXPR_)		do{ if(!(_EXPR_)){ mbed_assert_internal(#_EXPR_, __FILE__, __LINE__); } }while(0)
+
+/** Trazas de depuracion: (condicion, modulo, formato, argumentos) */
+#define HOST_TRACE(_LEVEL_, _EXPR_, _MODULE_, ...)	do{ if(_EXPR_){ host_trace(_LEVEL_, _MODULE_, __VA_ARGS__); } }while(0)
+#define DEBUG_TRACE_E(_EXPR_, _MODULE_, ...)	HOST_TRACE('E', _EXPR_, _MODULE_, __VA_ARGS__)
+#define DEBUG_TRACE_W(_EXPR_, _MODULE_, ...)	HOST_TRACE('W', _EXPR_, _MODULE_, __VA_ARGS__)
+#define DEBUG_TRACE_I(_EXPR_, _MODULE_, ...)	HOST_TRACE('I', _EXPR_, _MODULE_, __VA_ARGS__)
+#define DEBUG_TRACE_D(_EXPR_, _MODULE_, ...)	HOST_TRACE('D', _EXPR_, _MODULE_, __VA_ARGS__)
+#define DEBUG_TRACE_V(_EXPR_, _MODULE_, ...)	HOST_TRACE('V', _EXPR_, _MODULE_, __VA_ARGS__)
+
+#define IS_ISR()				host_in_isr()
+
+
+typedef enum {
+	osOK = 0,
+	osEventSignal = 0x08,
+	osEventMessage = 0x10,
+	osEventMail = 0x20,
+	osEventTimeout = 0x40,
+	osErrorParameter = 0x80,
+	osErrorResource = 0x81,
+	osErrorISR = 0x82,
+	osErrorNoMemory = 0x85,
+	osErrorValue = 0x86,
+	osErrorTimeout = 0xC1,
+	osErrorOS = 0xFF,
+} osStatus;
+
+typedef enum {
+	osPriorityIdle = 1,
+	osPriorityLow = 8,
+	osPriorityBelowNormal = 16,
+	osPriorityNormal = 24,
+	osPriorityAboveNormal = 32,
+	osPriorityHigh = 40,
+	osPriorityRealtime = 48,
+} osPriority;
+
+typedef struct {
+	osStatus status;
+	union {
+		uint32_t v;
+		void* p;
+		int32_t signals;
+	} value;
+} osEvent;
+
+
+void mbed_assert_internal(const char* expr, const char* file, int line);
+void host_trace(char level, const char* module, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+bool host_in_isr();
+void core_util_critical_section_enter();
+void core_util_critical_section_exit();
+uint32_t us_ticker_read();
+
+namespace Kernel {
+	uint64_t get_ms_count();
+}
+
+
+/** Ambito en el que IS_ISR() es cierto en el thread actual, para simular un productor en interrupcion */
+class HostIsrScope {
+  public:
+	HostIsrScope();
+	~HostIsrScope();
+};
+
+
+//------------------------------------------------------------------------------------
+//-- Callback ------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+
+template<typename F> class Callback;
+
+template<typename R, typename... A>
+class Callback<R(A...)> {
+  public:
+	Callback() {}
+	Callback(R (*func)(A...)) { if(func){ _f = func; } }
+	template<typename T, typename M>
+	Callback(T* obj, M method) : _f([obj, method](A... args){ return (obj->*method)(args...); }) {}
+
+	R call(A... args) const { return _f(args...); }
+	R operator()(A... args) const { return _f(args...); }
+	explicit operator bool() const { return (bool)_f; }
+
+  private:
+	std::function<R(A...)> _f;
+};
+
+template<typename R, typename... A>
+Callback<R(A...)> callback(R (*func)(A...)){
+	return Callback<R(A...)>(func);
+}
+
+template<typename T, typename U, typename R, typename... A>
+Callback<R(A...)> callback(U* obj, R (T::*method)(A...)){
+	return Callback<R(A...)>(obj, method);
+}
+
+
+//------------------------------------------------------------------------------------
+//-- Primitivas de sincronizacion ----------------------------------------------------
+//------------------------------------------------------------------------------------
+
+/** Mutex y variable de condicion sobre el reloj monotono, base de Semaphore, Queue y MemoryPool */
+class HostCond {
+  public:
+	HostCond();
+	~HostCond();
+	void lock() { pthread_mutex_lock(&_mtx); }
+	void unlock() { pthread_mutex_unlock(&_mtx); }
+	void broadcast() { pthread_cond_broadcast(&_cond); }
+
+	/** Espera una notificacion con el mutex tomado
+	 *  @param deadline_us Plazo absoluto (us_monotonic, 0: sin plazo)
+	 *  @return False si ha vencido el plazo
+	 */
+	bool wait(uint64_t deadline_us);
+
+	/** Plazo absoluto a partir de una espera en milisegundos (0: sin plazo para osWaitForever) */
+	static uint64_t deadline(uint32_t millisec);
+
+  private:
+	pthread_mutex_t _mtx;
+	pthread_cond_t _cond;
+};
+
+
+class Mutex {
+  public:
+	Mutex();
+	~Mutex();
+	osStatus lock(uint32_t millisec = osWaitForever);
+	bool trylock();
+	osStatus unlock();
+
+  private:
+	pthread_mutex_t _mtx;
+};
+
+
+class Semaphore {
+  public:
+	Semaphore(int32_t count = 0, uint16_t max_count = 0xFFFF);
+
+	/** Espera un token
+	 *  @return Tokens disponibles antes de tomarlo, 0 si vence la espera
+	 */
+	int32_t wait(uint32_t millisec = osWaitForever);
+	osStatus release();
+
+  private:
+	HostCond _cond;
+	int32_t _count;
+	int32_t _max;
+};
+
+
+class Thread {
+  public:
+	Thread(osPriority priority = osPriorityNormal, uint32_t stack_size = OS_STACK_SIZE, unsigned char* stack_mem = NULL, const char* name = NULL);
+	~Thread();
+	osStatus start(Callback<void()> task);
+	osStatus join();
+	osPriority get_priority() { return _priority; }
+	const char* get_name() { return _name; }
+	uint32_t stack_size() { return _stack_size; }
+	uint32_t max_stack();
+	uint32_t free_stack() { return (_stack_size > max_stack())? (_stack_size - max_stack()) : 0; }
+	uint32_t used_stack() { return max_stack(); }
+	static osStatus wait(uint32_t millisec);
+	static osStatus yield();
+
+  private:
+	osPriority _priority;
+	uint32_t _stack_size;
+	const char* _name;
+	uint8_t* _host_stack;
+	size_t _host_stack_size;
+	pthread_t _tid;
+	bool _started;
+	Callback<void()> _task;
+
+	static void* entry(void* arg);
+};
+
+
+/** Cola de punteros ordenada por prioridad (FIFO entre mensajes de la misma prioridad) */
+template<typename T, uint32_t queue_sz>
+class Queue {
+  public:
+	Queue() : _count(0) {}
+
+	osStatus put(T* data, uint32_t millisec = 0, uint8_t prio = 0){
+		uint64_t deadline = HostCond::deadline(millisec);
+		_cond.lock();
+		while(_count >= queue_sz){
+			if(millisec == 0 || !_cond.wait(deadline)){
+				_cond.unlock();
+				return (millisec == 0)? osErrorResource : osErrorTimeout;
+			}
+		}
+		uint32_t i = _count;
+		while(i > 0 && _items[i - 1].prio < prio){
+			_items[i] = _items[i - 1];
+			i--;
+		}
+		_items[i].data = data;
+		_items[i].prio = prio;
+		_count++;
+		_cond.broadcast();
+		_cond.unlock();
+		return osOK;
+	}
+
+	osEvent get(uint32_t millisec = osWaitForever){
+		osEvent oe;
+		oe.value.p = NULL;
+		uint64_t deadline = HostCond::deadline(millisec);
+		_cond.lock();
+		while(_count == 0){
+			if(millisec == 0 || !_cond.wait(deadline)){
+				_cond.unlock();
+				oe.status = (millisec == 0)? osOK : osEventTimeout;
+				return oe;
+			}
+		}
+		oe.status = osEventMessage;
+		oe.value.p = _items[0].data;
+		_count--;
+		memmove(&_items[0], &_items[1], _count * sizeof(Item));
+		_cond.broadcast();
+		_cond.unlock();
+		return oe;
+	}
+
+	bool empty() { return count() == 0; }
+	bool full() { return count() >= queue_sz; }
+	uint32_t count() { _cond.lock(); uint32_t n = _count; _cond.unlock(); return n; }
+
+  private:
+	struct Item {
+		T* data;
+		uint8_t prio;
+	};
+	HostCond _cond;
+	Item _items[queue_sz];
+	uint32_t _count;
+};
+
+
+/** Pool de bloques de tamano fijo */
+template<typename T, uint32_t pool_sz>
+class MemoryPool {
+  public:
+	MemoryPool() : _free(NULL) {
+		for(uint32_t i = pool_sz; i > 0; i--){
+			_blocks[i - 1].next = _free;
+			_free = &_blocks[i - 1];
+		}
+	}
+
+	T* alloc(){
+		_cond.lock();
+		Block* b = _free;
+		if(b){
+			_free = b->next;
+		}
+		_cond.unlock();
+		return (T*)b;
+	}
+
+	T* calloc(){
+		T* b = alloc();
+		if(b){
+			memset((void*)b, 0, sizeof(T));
+		}
+		return b;
+	}
+
+	osStatus free(T* block){
+		if(!block){
+			return osErrorParameter;
+		}
+		_cond.lock();
+		((Block*)block)->next = _free;
+		_free = (Block*)block;
+		_cond.unlock();
+		return osOK;
+	}
+
+  private:
+	union Block {
+		Block* next;
+		MBED_ALIGN(8) uint8_t mem[sizeof(T)];
+	};
+	HostCond _cond;
+	Block _blocks[pool_sz];
+	Block* _free;
+};
+
+#endif /*__mbed__H */
+
+/**** END OF FILE ****/
@@ -0,0 +1,87 @@
+#!/usr/bin/env python
+# Decodifica un volcado binario de TraceRecorder (ActiveModule::dumpTrace). Para reproducirlo sobre un modulo en el
+# host, ver tools/trace_replay.cpp
+import sys, getopt, struct
+
+HEADER_FMT = '<IHHHHII16s'
+RECORD_FMT = '<IIIIIHBB'
+FILE_MAGIC = 0x52544D41
+KINDS = {1: 'PUT', 2: 'DISPATCH', 3: 'REJECT'}
+
+
+def usage():
+  print('trace_decode.py -h -f <trace_file> [-c <csv_file>]')
+  sys.exit(2)
+
+
+if __name__ == '__main__':
+  argv = sys.argv[1:]
+
+  try:
+      opts, args = getopt.getopt(argv,"hf:c:", ["file=", "csv="])
+  except getopt.GetoptError:
+      usage()
+
+  filename = ''
+  csvname = ''
+
+  for opt, arg in opts:
+      if opt in("-f", "--file"):
+          filename = arg
+      elif opt in("-c", "--csv"):
+          csvname = arg
+      else:
+        usage()
+
+  if filename == '':
+    usage()
+
+  data = open(filename, 'rb').read()
+  hsize = struct.calcsize(HEADER_FMT)
+  magic, version, record_size, payload_size, _, count, lost, name = struct.unpack_from(HEADER_FMT, data, 0)
+  if magic != FILE_MAGIC:
+    print('Error: invalid trace file')
+    sys.exit(2)
+  name = name.split(b'\0')[0].decode('ascii', 'replace')
+  print('Module: %s, version: %d, records: %d, lost: %d' % (name, version, count, lost))
+
+  rsize = struct.calcsize(RECORD_FMT)
+  records = []
+  for i in range(count):
+    offset = hsize + i * record_size
+    if offset + record_size > len(data):
+      break
+    seq, ts, sig, hsh, duration, size, kind, state = struct.unpack_from(RECORD_FMT, data, offset)
+    if seq == 0:
+      continue
+    payload = data[offset + rsize: offset + rsize + min(size, payload_size)]
+    records.append((seq, ts, sig, hsh, duration, size, kind, state, payload))
+
+  # lineas de registro con tiempo relativo al primer registro valido
+  lines = ['seq,time_us,kind,sig,size,hash,duration_us,state,data']
+  t0 = records[0][1] if records else 0
+  for (seq, ts, sig, hsh, duration, size, kind, state, payload) in records:
+    lines.append('%d,%d,%s,0x%x,%d,0x%08x,%d,%d,%s' % (seq, (ts - t0) & 0xFFFFFFFF, KINDS.get(kind, kind), sig, size, hsh, duration, state,
+                 ''.join('%02x' % b for b in bytearray(payload))))
+
+  if csvname != '':
+    f = open(csvname, 'w')
+    f.write('\n'.join(lines) + '\n')
+    f.close()
+    print('Saved %d records to %s' % (len(records), csvname))
+  else:
+    for l in lines:
+      print(l)
+
+  # resumen por senal de los despachos
+  summary = {}
+  for r in records:
+    if r[6] == 2:
+      s = summary.setdefault(r[2], [0, 0, 0])
+      s[0] += 1
+      s[1] += r[4]
+      s[2] = max(s[2], r[4])
+  print('\nsig,count,avg_us,max_us')
+  for sig in sorted(summary):
+    c, t, m = summary[sig]
+    print('0x%x,%d,%d,%d' % (sig, c, t // c, m))
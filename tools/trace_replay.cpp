@@ -0,0 +1,183 @@
+/*
+ * trace_replay.cpp
+ *
+ *  Version: 17 Oct 2026
+ *  Author: raulMrello
+ *
+ *	Herramienta de host que reproduce en un modulo los mensajes encolados de un volcado de TraceRecorder
+ *	(ActiveModule::dumpTrace), a la velocidad original o a maxima velocidad, y compara por senal los tiempos de
+ *	los manejadores registrados en el volcado con los medidos durante la reproduccion (ActiveModule::getMetrics).
+ *
+ *	Por defecto los mensajes se reproducen sobre un modulo sumidero que solo los despacha (coste del camino
+ *	putMessage -> run). Para reproducirlos sobre un modulo real se enlaza la herramienta con una definicion de
+ *	createReplayModule que lo construya.
+ *
+ *	Uso: trace_replay -f <trace_file> [-r] [-o <trace_file>]
+ *		-r	respeta los intervalos originales entre mensajes
+ *		-o	vuelca el registro del modulo durante la reproduccion (decodificable con trace_decode.py)
+ */
+
+#include "mbed.h"
+#include "ActiveModule.h"
+#include "TraceRecorder.h"
+#include <unistd.h>
+#include <map>
+
+
+//------------------------------------------------------------------------------------
+//-- PRIVATE TYPEDEFS ----------------------------------------------------------------
+//------------------------------------------------------------------------------------
+static const uint32_t DrainTimeoutMillis = 5000;
+
+
+/** Modulo sumidero: despacha los mensajes reproducidos sin procesarlos */
+class ReplaySink : public ActiveModule {
+  public:
+	ReplaySink(const char* name) : ActiveModule(name) {
+		_publicationCb = callback(this, &ReplaySink::publicationCb);
+		_subscriptionCb = callback(this, &ReplaySink::subscriptionCb);
+	}
+
+  protected:
+	virtual State::StateResult Init_EventHandler(State::StateEvent* /*se*/) { return State::HANDLED; }
+	virtual void subscriptionCb(const char* /*topic*/, void* /*msg*/, uint16_t /*msg_len*/) {}
+	virtual void publicationCb(const char* /*topic*/, int32_t /*result*/) {}
+	virtual bool checkIntegrity() { return true; }
+	virtual void setDefaultConfig() {}
+	virtual void restoreConfig() {}
+	virtual void saveConfig() {}
+};
+
+
+/** Crea el modulo sobre el que se reproduce el volcado. Redefinible al enlazar con un modulo real.
+ *  @param name Nombre del modulo registrado en el volcado
+ *  @return Modulo (se arranca con start())
+ */
+__attribute__((weak)) ActiveModule* createReplayModule(const char* name){
+	return new ReplaySink(name);
+}
+
+
+/** Tiempos de los manejadores de una senal */
+struct SignalTimes {
+	uint32_t count;
+	uint64_t total_us;
+	uint32_t max_us;
+};
+
+
+static void usage(){
+	printf("trace_replay -f <trace_file> [-r] [-o <trace_file>]\n");
+	exit(2);
+}
+
+
+//------------------------------------------------------------------------------------
+int main(int argc, char* argv[]){
+	const char* filename = NULL;
+	const char* outname = NULL;
+	bool realtime = false;
+	int opt;
+	while((opt = getopt(argc, argv, "hf:ro:")) != -1){
+		switch(opt){
+			case 'f': filename = optarg; break;
+			case 'r': realtime = true; break;
+			case 'o': outname = optarg; break;
+			default: usage();
+		}
+	}
+	if(!filename){
+		usage();
+	}
+	FILE* f = fopen(filename, "rb");
+	TraceRecorder::TraceFileHeader hdr;
+	if(!f || fread(&hdr, sizeof(hdr), 1, f) != 1 || hdr.magic != TraceRecorder::FileMagic || hdr.record_size != sizeof(TraceRecorder::Record)){
+		printf("Error: volcado no valido %s\n", filename);
+		return 2;
+	}
+	// el nombre se registra como "[Name]....", el modulo se crea sin decoracion
+	char name[sizeof(hdr.name) + 1] = {0};
+	memcpy(name, (hdr.name[0] == '[')? &hdr.name[1] : hdr.name, sizeof(hdr.name) - 1);
+	name[strcspn(name, "]")] = 0;
+
+	// tiempos de los manejadores registrados en el volcado
+	std::map<uint32_t, SignalTimes> original;
+	uint32_t puts = 0;
+	TraceRecorder::Record r;
+	for(uint32_t i = 0; i < hdr.count && fread(&r, sizeof(r), 1, f) == 1; i++){
+		if(r.seq == 0){
+			continue;
+		}
+		if(r.kind == TraceRecorder::RecPut){
+			puts++;
+		}
+		else if(r.kind == TraceRecorder::RecDispatch){
+			SignalTimes& t = original[r.sig];
+			t.count++;
+			t.total_us += r.duration;
+			t.max_us = (r.duration > t.max_us)? r.duration : t.max_us;
+		}
+	}
+	printf("Modulo: %s, registros: %u, perdidos: %u, mensajes encolados: %u\n", name, (unsigned)hdr.count, (unsigned)hdr.lost, (unsigned)puts);
+
+	ActiveModule* module = createReplayModule(name);
+	module->start();
+	while(!module->isStarted()){
+		Thread::wait(1);
+	}
+	if(outname){
+		uint32_t records = 16;
+		while(records < 2 * puts){
+			records <<= 1;
+		}
+		module->enableTrace(records);
+	}
+	module->resetMetrics();
+
+	// reproduccion y espera del despacho de los mensajes posteados
+	TraceReplay::Stats stats;
+	rewind(f);
+	TraceReplay::replay(f, module, realtime, stats);
+	fclose(f);
+	ActiveModule::Metrics m;
+	uint64_t deadline = Kernel::get_ms_count() + DrainTimeoutMillis;
+	do{
+		Thread::wait(1);
+		module->getMetrics(m);
+	}while(m.dispatched < stats.posted && Kernel::get_ms_count() < deadline);
+	printf("Reproduccion %s: posteados %u, fallidos %u, truncados %u, despachados %u en %u us (%.0f eventos/s)\n",
+			(realtime)? "en tiempo real" : "a maxima velocidad", (unsigned)stats.posted, (unsigned)stats.failed,
+			(unsigned)stats.truncated, (unsigned)m.dispatched, (unsigned)stats.elapsed_us,
+			(stats.elapsed_us)? (double)stats.posted * 1000000.0 / (double)stats.elapsed_us : 0.0);
+
+	// comparativa por senal: volcado frente a reproduccion
+	printf("\n%-12s %10s %10s %10s %10s %10s %10s\n", "sig", "count", "avg_us", "max_us", "rp_count", "rp_avg_us", "rp_max_us");
+	for(uint16_t i = 0; i < m.num_signals; i++){
+		original[m.signals[i].sig];
+	}
+	for(std::map<uint32_t, SignalTimes>::iterator it = original.begin(); it != original.end(); ++it){
+		const SignalTimes& o = it->second;
+		ActiveModule::SignalMetrics rp = { it->first, 0, 0, 0 };
+		for(uint16_t i = 0; i < m.num_signals; i++){
+			if(m.signals[i].sig == it->first){
+				rp = m.signals[i];
+			}
+		}
+		printf("0x%-10x %10u %10u %10u %10u %10u %10u\n", (unsigned)it->first, (unsigned)o.count,
+				(unsigned)((o.count)? o.total_us / o.count : 0), (unsigned)o.max_us, (unsigned)rp.count,
+				(unsigned)((rp.count)? rp.total_us / rp.count : 0), (unsigned)rp.max_us);
+	}
+
+	if(outname){
+		FILE* out = fopen(outname, "wb");
+		if(!out){
+			printf("Error: no se puede crear %s\n", outname);
+			return 2;
+		}
+		printf("\nVolcados %u registros en %s\n", (unsigned)module->dumpTrace(out), outname);
+		fclose(out);
+	}
+	return 0;
+}
+
+/**** END OF FILE ****/